@@ -0,0 +1,262 @@
+#!/usr/bin/python3
+
+##
+## benchmarks/generate_codebase.py
+##
+## Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+##
+## Licensed under the Apache License, Version 2.0 (the "License");
+## you may not use this file except in compliance with the License.
+## You may obtain a copy of the License at
+##
+##     http://www.apache.org/licenses/LICENSE-2.0
+##
+## Unless required by applicable law or agreed to in writing, software
+## distributed under the License is distributed on an "AS IS" BASIS,
+## WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+## See the License for the specific language governing permissions and
+## limitations under the License.
+##
+
+"""
+Generates a synthetic C++ codebase for benchmarking clang-uml.
+
+The generated codebase contains:
+  * `--classes` classes spread over `--namespaces` namespaces, each in
+    a separate header, with members, base classes and dependencies on other
+    classes,
+  * `--templates` class templates, each nesting the previous one, which
+    are instantiated by the classes,
+  * `--translation-units` source files, each including a subset of
+    headers and defining an entry function starting a call chain of
+    `--call-depth` method calls across classes,
+  * `compile_commands.json` and `.clang-uml` with class, sequence, package
+    and include diagrams.
+"""
+
+import argparse
+import json
+import os
+import random
+import shlex
+import sys
+
+
+def namespace_of(i, args):
+    return f'ns{i % args.namespaces}'
+
+
+def class_name(i):
+    return f'C{i}'
+
+
+def qualified_class_name(i, args):
+    return f'bench::{namespace_of(i, args)}::{class_name(i)}'
+
+
+def header_path(i, args):
+    return f'bench/{namespace_of(i, args)}/{class_name(i).lower()}.h'
+
+
+def generate_templates(args):
+    lines = ['#pragma once', '', '#include <array>', '#include <memory>',
+             '', 'namespace bench::templates {', '']
+
+    for j in range(args.templates):
+        lines.append('template <typename T, int N> struct T%d {' % j)
+        lines.append('    std::array<T, N> values;')
+        if j > 0:
+            lines.append(f'    std::unique_ptr<T{j - 1}<T, N>> next;')
+        lines.append('    T get(int i) const { return values[i % N]; }')
+        lines.append('};')
+        lines.append('')
+
+    lines.append('} // namespace bench::templates')
+    lines.append('')
+
+    return '\n'.join(lines)
+
+
+def generate_class(i, rnd, args):
+    ns = namespace_of(i, args)
+    name = class_name(i)
+
+    # Only refer to classes with lower index to avoid include cycles
+    base = rnd.randrange(i) if i > 0 and rnd.random() < 0.3 else None
+    members = sorted(set(rnd.randrange(i)
+                         for _ in range(min(i, args.members))))
+    peer = i - 1 if i > 0 else None
+
+    includes = ['#pragma once', '']
+    if args.templates > 0:
+        includes.append('#include "bench/templates.h"')
+    for k in sorted(set(members + [x for x in (base, peer) if x is not None])):
+        includes.append(f'#include "{header_path(k, args)}"')
+    includes.append('')
+
+    lines = includes + [f'namespace bench::{ns} {{', '']
+
+    if base is not None:
+        lines.append(f'class {name} : public {qualified_class_name(base, args)} {{')
+    else:
+        lines.append(f'class {name} {{')
+    lines.append('public:')
+
+    # Call chain methods - m0() calls peer's m1() and so on, so that
+    # a sequence diagram started from an entry function is call-depth deep
+    for d in range(args.call_depth):
+        lines.append(f'    int m{d}(int x)')
+        lines.append('    {')
+        if d + 1 < args.call_depth and peer is not None:
+            lines.append(f'        if (peer_ != nullptr)')
+            lines.append(f'            return peer_->m{d + 1}(x + {d});')
+        lines.append(f'        return x + {i};')
+        lines.append('    }')
+        lines.append('')
+
+    lines.append('private:')
+    for k in members:
+        lines.append(f'    {qualified_class_name(k, args)} member_{k}_;')
+    if peer is not None:
+        lines.append(f'    {qualified_class_name(peer, args)} *peer_{{nullptr}};')
+    if args.templates > 0:
+        t = i % args.templates
+        lines.append(f'    bench::templates::T{t}<int, {1 + i % 8}> t_;')
+    lines.append('};')
+    lines.append('')
+    lines.append(f'}} // namespace bench::{ns}')
+    lines.append('')
+
+    return '\n'.join(lines)
+
+
+def generate_translation_unit(k, rnd, args):
+    # Each translation unit starts a call chain from a different class
+    root = (k * 7919) % args.classes
+    headers = {root} | set(rnd.randrange(args.classes)
+                           for _ in range(args.includes))
+
+    lines = [f'#include "{header_path(h, args)}"' for h in sorted(headers)]
+    lines += ['', 'namespace bench {', '']
+    lines.append(f'int tu{k}_entry(int x)')
+    lines.append('{')
+    lines.append(f'    {qualified_class_name(root, args)} root;')
+    lines.append('    return root.m0(x);')
+    lines.append('}')
+    lines.append('')
+    lines.append('} // namespace bench')
+    lines.append('')
+
+    return '\n'.join(lines)
+
+
+def generate_config(args):
+    return f"""compilation_database_dir: .
+output_directory: diagrams
+diagrams:
+  bench_class:
+    type: class
+    glob:
+      - src/*.cc
+    include:
+      namespaces:
+        - bench
+    using_namespace: bench
+  bench_sequence:
+    type: sequence
+    glob:
+      - src/tu0.cc
+    include:
+      namespaces:
+        - bench
+    using_namespace: bench
+    from:
+      - function: "bench::tu0_entry(int)"
+  bench_package:
+    type: package
+    glob:
+      - src/*.cc
+    include:
+      namespaces:
+        - bench
+    using_namespace: bench
+  bench_include:
+    type: include
+    glob:
+      - src/*.cc
+    include:
+      paths:
+        - include
+        - src
+"""
+
+
+def write(path, content):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, 'w') as f:
+        f.write(content)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description='Generate synthetic C++ codebase for clang-uml benchmarks')
+    parser.add_argument('--output', required=True,
+                        help='Output directory')
+    parser.add_argument('--classes', type=int, default=1000,
+                        help='Number of classes')
+    parser.add_argument('--namespaces', type=int, default=10,
+                        help='Number of namespaces')
+    parser.add_argument('--templates', type=int, default=20,
+                        help='Number of class templates')
+    parser.add_argument('--translation-units', type=int, default=50,
+                        help='Number of translation units')
+    parser.add_argument('--call-depth', type=int, default=10,
+                        help='Depth of call chains started in each '
+                             'translation unit')
+    parser.add_argument('--members', type=int, default=3,
+                        help='Maximum number of members of each class')
+    parser.add_argument('--includes', type=int, default=20,
+                        help='Number of headers included by each '
+                             'translation unit')
+    parser.add_argument('--compiler', default='clang++',
+                        help='Compiler used in compile_commands.json')
+    parser.add_argument('--seed', type=int, default=1,
+                        help='Random generator seed')
+
+    args = parser.parse_args(argv)
+
+    if args.classes < 1 or args.namespaces < 1 or args.call_depth < 1:
+        parser.error('--classes, --namespaces and --call-depth must be >= 1')
+
+    rnd = random.Random(args.seed)
+    output = os.path.abspath(args.output)
+
+    if args.templates > 0:
+        write(os.path.join(output, 'include', 'bench', 'templates.h'),
+              generate_templates(args))
+
+    for i in range(args.classes):
+        write(os.path.join(output, 'include', header_path(i, args)),
+              generate_class(i, rnd, args))
+
+    compile_commands = []
+    for k in range(args.translation_units):
+        source = os.path.join('src', f'tu{k}.cc')
+        write(os.path.join(output, source),
+              generate_translation_unit(k, rnd, args))
+        compile_commands.append({
+            'directory': output,
+            'file': os.path.join(output, source),
+            'command': ' '.join(shlex.quote(a) for a in [
+                args.compiler, '-std=c++17', '-Iinclude', '-c', source])})
+
+    write(os.path.join(output, 'compile_commands.json'),
+          json.dumps(compile_commands, indent=2))
+    write(os.path.join(output, '.clang-uml'), generate_config(args))
+
+    print(f'Generated {args.classes} classes, {args.templates} templates '
+          f'and {args.translation_units} translation units in {output}')
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
@@ -0,0 +1,559 @@
+/**
+ * @file benchmarks/model_benchmarks.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "class_diagram/generators/json/class_diagram_generator.h"
+#include "class_diagram/generators/mermaid/class_diagram_generator.h"
+#include "class_diagram/generators/plantuml/class_diagram_generator.h"
+#include "class_diagram/model/class.h"
+#include "class_diagram/model/diagram.h"
+#include "common/clang_utils.h"
+#include "common/generators/profiler.h"
+#include "common/model/diagram_filter.h"
+#include "common/model/package.h"
+#include "config/config.h"
+#include "package_diagram/generators/json/package_diagram_generator.h"
+#include "package_diagram/generators/mermaid/package_diagram_generator.h"
+#include "package_diagram/generators/plantuml/package_diagram_generator.h"
+#include "package_diagram/model/diagram.h"
+#include "sequence_diagram/generators/json/sequence_diagram_generator.h"
+#include "sequence_diagram/generators/mermaid/sequence_diagram_generator.h"
+#include "sequence_diagram/generators/plantuml/sequence_diagram_generator.h"
+#include "sequence_diagram/model/diagram.h"
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Microbenchmarks of the diagram model, filter and generator hot paths.
+ *
+ * The benchmarks build in-memory class, package and sequence diagram models
+ * of a given size without invoking Clang, so that changes to the model
+ * layer data structures can be evaluated quickly. Each benchmark is run
+ * for each size provided on the command line (by default 1000 and 10000
+ * elements) and reports the total time, number of operations per second,
+ * number of heap allocations and deallocations and number of bytes
+ * allocated by the benchmark.
+ *
+ * Usage: model_benchmarks [-c model_benchmarks.yml] [size...]
+ */
+
+using namespace clanguml;
+using clanguml::common::eid_t;
+using clanguml::common::model::diagram_filter;
+using clanguml::common::model::namespace_;
+using clanguml::common::model::relationship;
+using clanguml::common::model::relationship_t;
+
+namespace {
+
+// Prevents the compiler from optimizing away benchmarked calls
+volatile size_t sink{0}; // NOLINT
+
+// Number of calls to the global operator new and delete replaced below
+std::atomic<size_t> allocations{0};     // NOLINT
+std::atomic<size_t> deallocations{0};   // NOLINT
+std::atomic<size_t> allocated_bytes{0}; // NOLINT
+
+void deallocate(void *p) noexcept
+{
+    if (p != nullptr)
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+
+    std::free(p); // NOLINT
+}
+
+template <typename F> void run(const std::string &name, size_t size, F &&f)
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto allocations_start = allocations.load();
+    const auto deallocations_start = deallocations.load();
+    const auto allocated_bytes_start = allocated_bytes.load();
+    const auto start = clock::now();
+    const size_t ops = f();
+    const auto ms =
+        std::chrono::duration<double, std::milli>(clock::now() - start)
+            .count();
+
+    std::cout << fmt::format(
+        "{:<44} {:>9} {:>10} {:>12.3f} {:>14.0f} {:>10} {:>10} {:>12}\n",
+        name, size, ops, ms,
+        ms > 0 ? static_cast<double>(ops) / (ms / 1000.0) : 0.0,
+        allocations.load() - allocations_start,
+        deallocations.load() - deallocations_start,
+        allocated_bytes.load() - allocated_bytes_start);
+}
+
+template <typename Generator, typename Config, typename Model>
+size_t generate(Config &config, Model &model)
+{
+    std::ostringstream ss;
+    ss << Generator{config, model};
+    return ss.str().size();
+}
+
+//
+// Class diagram
+//
+std::string class_namespace(size_t i)
+{
+    return fmt::format("bench::ns{}::sub{}", i % 10, (i / 10) % 10);
+}
+
+std::string class_full_name(size_t i)
+{
+    return fmt::format("{}::C{}", class_namespace(i), i);
+}
+
+void add_class_diagram_packages(class_diagram::model::diagram &d)
+{
+    auto add_package = [&d](const std::string &ns, const std::string &name) {
+        auto p = std::make_unique<common::model::package>(namespace_{});
+        p->set_name(name);
+        p->set_namespace(namespace_{ns});
+        p->set_id(common::to_id((namespace_{ns} | name).to_string()));
+        const auto path = p->path();
+        (void)d.add(path, std::move(p));
+    };
+
+    add_package("", "bench");
+    for (auto ns = 0; ns < 10; ns++) {
+        add_package("bench", fmt::format("ns{}", ns));
+        for (auto sub = 0; sub < 10; sub++)
+            add_package(
+                fmt::format("bench::ns{}", ns), fmt::format("sub{}", sub));
+    }
+}
+
+std::unique_ptr<class_diagram::model::class_> make_class(size_t i, size_t n)
+{
+    auto c = std::make_unique<class_diagram::model::class_>(namespace_{});
+    c->set_name(fmt::format("C{}", i));
+    c->set_namespace(namespace_{class_namespace(i)});
+    c->set_id(common::to_id(class_full_name(i)));
+
+    if (i > 0 && i % 3 == 0) {
+        const auto parent = i / 10;
+        c->add_parent(
+            class_diagram::model::class_parent{class_full_name(parent)});
+        c->add_relationship(relationship{relationship_t::kExtension,
+            common::to_id(class_full_name(parent))});
+        // Redundant dependency removed by remove_redundant_dependencies()
+        c->add_relationship(relationship{relationship_t::kDependency,
+            common::to_id(class_full_name(parent))});
+    }
+
+    c->add_relationship(relationship{relationship_t::kAssociation,
+        common::to_id(class_full_name((i * 31 + 7) % n))});
+    c->add_relationship(relationship{relationship_t::kDependency,
+        common::to_id(class_full_name((i * 17 + 3) % n))});
+
+    for (auto m = 0; m < 3; m++) {
+        c->add_member(class_diagram::model::class_member{
+            common::model::access_t::kPrivate, fmt::format("member_{}", m),
+            "std::vector<std::string>"});
+
+        class_diagram::model::class_method method{
+            common::model::access_t::kPublic, fmt::format("method_{}", m),
+            "int"};
+        method.add_parameter(
+            class_diagram::model::method_parameter{"const std::string &", "s"});
+        c->add_method(std::move(method));
+    }
+
+    return c;
+}
+
+void run_class_diagram_benchmarks(config::config &cfg, size_t n)
+{
+    using class_diagram::model::class_;
+
+    auto &config =
+        dynamic_cast<config::class_diagram &>(*cfg.diagrams.at("bench_class"));
+
+    // Allocated on the heap, so that its teardown can be measured
+    auto model = std::make_unique<class_diagram::model::diagram>();
+    auto &d = *model;
+
+    run("class_diagram::add", n, [&]() {
+        add_class_diagram_packages(d);
+        for (auto i = 0U; i < n; i++) {
+            auto c = make_class(i, n);
+            const auto path = c->path();
+            sink = sink + static_cast<size_t>(d.add(path, std::move(c)));
+        }
+        return n;
+    });
+
+    d.set_filter(std::make_unique<diagram_filter>(d, config));
+    d.set_complete(true);
+
+    run("class_diagram::find<class_>(name)", n, [&]() {
+        for (auto i = 0U; i < n; i++)
+            sink = sink + d.find<class_>(class_full_name(i)).has_value();
+        return n;
+    });
+
+    run("class_diagram::find<class_>(id)", n, [&]() {
+        for (auto i = 0U; i < n; i++)
+            sink = sink +
+                d.find<class_>(common::to_id(class_full_name(i))).has_value();
+        return n;
+    });
+
+    run("class_diagram::get(name)", n, [&]() {
+        for (auto i = 0U; i < n; i++)
+            sink = sink + d.get(class_full_name(i)).has_value();
+        return n;
+    });
+
+    run("class_diagram::get(id)", n, [&]() {
+        for (auto i = 0U; i < n; i++)
+            sink = sink + d.get(common::to_id(class_full_name(i))).has_value();
+        return n;
+    });
+
+    // Each filter configuration exercises a single filter visitor, including
+    // its lazy initialization on first match
+    for (const auto *filter_name :
+        {"bench_class", "bench_class_namespaces", "bench_class_elements",
+            "bench_class_element_types", "bench_class_relationships",
+            "bench_class_subclasses", "bench_class_parents",
+            "bench_class_dependants", "bench_class_dependencies",
+            "bench_class_context"}) {
+        diagram_filter filter{d, *cfg.diagrams.at(filter_name)};
+
+        run(fmt::format("diagram_filter::should_include({})", filter_name), n,
+            [&]() {
+                size_t ops{0};
+                for (const auto &c : d.classes()) {
+                    sink = sink + filter.should_include(c.get());
+                    ops++;
+                    for (const auto &r : c.get().relationships()) {
+                        sink = sink + filter.should_include(r.type());
+                        ops++;
+                    }
+                }
+                return ops;
+            });
+    }
+
+    run("class_diagram::remove_redundant_dependencies", n, [&]() {
+        d.remove_redundant_dependencies();
+        return n;
+    });
+
+    run("class_diagram::generators::plantuml", n, [&]() {
+        return generate<class_diagram::generators::plantuml::generator>(
+            config, d);
+    });
+
+    run("class_diagram::generators::json", n, [&]() {
+        return generate<class_diagram::generators::json::generator>(config, d);
+    });
+
+    run("class_diagram::generators::mermaid", n, [&]() {
+        return generate<class_diagram::generators::mermaid::generator>(
+            config, d);
+    });
+
+    run("class_diagram::~diagram", n, [&]() {
+        model.reset();
+        return n;
+    });
+}
+
+//
+// Package diagram
+//
+void run_package_diagram_benchmarks(config::config &cfg, size_t n)
+{
+    using common::model::package;
+
+    auto &config = dynamic_cast<config::package_diagram &>(
+        *cfg.diagrams.at("bench_package"));
+
+    auto model = std::make_unique<package_diagram::model::diagram>();
+    auto &d = *model;
+
+    // Packages form a tree, where each package has up to 10 subpackages
+    std::vector<namespace_> parents(n);
+    std::vector<namespace_> paths(n);
+    std::vector<eid_t> ids(n);
+    for (auto i = 0U; i < n; i++) {
+        parents[i] = i == 0 ? namespace_{"bench"} : paths[(i - 1) / 10];
+        paths[i] = parents[i] | fmt::format("p{}", i);
+        ids[i] = common::to_id(paths[i].to_string());
+    }
+
+    run("package_diagram::add", n, [&]() {
+        auto root = std::make_unique<package>(namespace_{});
+        root->set_name("bench");
+        root->set_id(common::to_id(std::string{"bench"}));
+        const auto root_path = root->path();
+        (void)d.add(root_path, std::move(root));
+
+        for (auto i = 0U; i < n; i++) {
+            auto p = std::make_unique<package>(namespace_{});
+            p->set_name(paths[i].name());
+            p->set_namespace(parents[i]);
+            p->set_id(ids[i]);
+            p->add_relationship(relationship{
+                relationship_t::kDependency, ids[(i * 7 + 3) % n]});
+            const auto path = p->path();
+            sink = sink + static_cast<size_t>(d.add(path, std::move(p)));
+        }
+        return n;
+    });
+
+    d.set_filter(std::make_unique<diagram_filter>(d, config));
+    d.set_complete(true);
+
+    run("package_diagram::find<package>(name)", n, [&]() {
+        for (auto i = 0U; i < n; i++)
+            sink = sink + d.find<package>(paths[i].to_string()).has_value();
+        return n;
+    });
+
+    run("package_diagram::get(id)", n, [&]() {
+        for (auto i = 0U; i < n; i++)
+            sink = sink + d.get(ids[i]).has_value();
+        return n;
+    });
+
+    diagram_filter filter{d, config};
+    run("package_diagram::should_include(package)", n, [&]() {
+        for (auto i = 0U; i < n; i++) {
+            if (auto p = d.find<package>(ids[i]); p)
+                sink = sink + filter.should_include(p.value());
+        }
+        return n;
+    });
+
+    run("package_diagram::generators::plantuml", n, [&]() {
+        return generate<package_diagram::generators::plantuml::generator>(
+            config, d);
+    });
+
+    run("package_diagram::generators::json", n, [&]() {
+        return generate<package_diagram::generators::json::generator>(
+            config, d);
+    });
+
+    run("package_diagram::generators::mermaid", n, [&]() {
+        return generate<package_diagram::generators::mermaid::generator>(
+            config, d);
+    });
+
+    run("package_diagram::~diagram", n, [&]() {
+        model.reset();
+        return n;
+    });
+}
+
+//
+// Sequence diagram
+//
+void run_sequence_diagram_benchmarks(config::config &cfg, size_t n)
+{
+    using common::model::message_t;
+    using sequence_diagram::model::function;
+    using sequence_diagram::model::message;
+    using sequence_diagram::model::participant;
+
+    auto &config = dynamic_cast<config::sequence_diagram &>(
+        *cfg.diagrams.at("bench_sequence"));
+
+    auto model = std::make_unique<sequence_diagram::model::diagram>();
+    auto &d = *model;
+
+    // bench::main() calls n / depth independent call chains of given depth
+    constexpr auto kDepth{10U};
+    const auto chains = std::max<size_t>(1, n / kDepth);
+
+    auto function_id = [](size_t i) {
+        return common::to_id(fmt::format("bench::f{}()", i));
+    };
+
+    const auto main_id = common::to_id(std::string{"bench::main()"});
+
+    run("sequence_diagram::add_participant", n, [&]() {
+        auto add_function = [&d](const std::string &name, eid_t id) {
+            auto f = std::make_unique<function>(namespace_{});
+            f->set_name(name);
+            f->set_namespace(namespace_{"bench"});
+            f->set_id(id);
+            d.add_participant(std::move(f));
+        };
+
+        add_function("main", main_id);
+        for (auto i = 0U; i < chains * kDepth; i++)
+            add_function(fmt::format("f{}", i), function_id(i));
+
+        return chains * kDepth + 1;
+    });
+
+    run("sequence_diagram::add_message", n, [&]() {
+        // Calls of each chain are made from the same source file
+        auto call = [&d](eid_t from, eid_t to, const std::string &name,
+                        size_t chain, unsigned int line) {
+            message m{message_t::kCall, from};
+            m.set_to(to);
+            m.set_message_name(name);
+            m.set_return_type("void");
+            m.set_file_relative(fmt::format("src/bench/chain{}.cc", chain));
+            m.set_file(
+                fmt::format("/home/bench/project/{}", m.file_relative()));
+            m.set_translation_unit(m.file());
+            m.set_line(line);
+            d.add_message(std::move(m));
+        };
+
+        for (auto k = 0U; k < chains; k++) {
+            call(main_id, function_id(k * kDepth), "f()", k, 1);
+            for (auto level = 0U; level + 1 < kDepth; level++)
+                call(function_id(k * kDepth + level),
+                    function_id(k * kDepth + level + 1), "f()", k, level + 2);
+        }
+
+        return chains * kDepth;
+    });
+
+    // Activities are copied, when message chains are resolved during
+    // finalization and generation of the diagram
+    run("sequence_diagram::copy(activity)", n, [&]() {
+        size_t ops{0};
+        for (const auto &[id, a] : d.sequences()) {
+            const auto copy = a;
+            ops += copy.messages().size();
+        }
+        return ops;
+    });
+
+    d.set_filter(std::make_unique<diagram_filter>(d, config));
+    d.set_complete(true);
+
+    run("sequence_diagram::get_participant", n, [&]() {
+        for (auto i = 0U; i < chains * kDepth; i++)
+            sink = sink +
+                d.get_participant<participant>(function_id(i)).has_value();
+        return chains * kDepth;
+    });
+
+    diagram_filter filter{d, config};
+    run("sequence_diagram::should_include(participant)", n, [&]() {
+        for (const auto &[id, p] : d.participants())
+            sink = sink + filter.should_include(*p);
+        return d.participants().size();
+    });
+
+    run("sequence_diagram::get_all_from_to_message_chains", n, [&]() {
+        size_t ops{0};
+        for (auto k = 0U; k < chains; k++) {
+            ops += d.get_all_from_to_message_chains(
+                        main_id, function_id(k * kDepth + kDepth - 1))
+                       .size();
+        }
+        return ops;
+    });
+
+    run("sequence_diagram::generators::plantuml", n, [&]() {
+        return generate<sequence_diagram::generators::plantuml::generator>(
+            config, d);
+    });
+
+    run("sequence_diagram::generators::json", n, [&]() {
+        return generate<sequence_diagram::generators::json::generator>(
+            config, d);
+    });
+
+    run("sequence_diagram::generators::mermaid", n, [&]() {
+        return generate<sequence_diagram::generators::mermaid::generator>(
+            config, d);
+    });
+
+    run("sequence_diagram::~diagram", n, [&]() {
+        model.reset();
+        return n;
+    });
+}
+} // namespace
+
+// Count heap allocations, other forms of operator new and delete use these
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void *p = std::malloc(size == 0 ? 1 : size); p != nullptr) // NOLINT
+        return p;
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept { deallocate(p); }
+
+void operator delete(void *p, std::size_t /*size*/) noexcept { deallocate(p); }
+
+int main(int argc, const char *argv[])
+{
+    std::string config_path{"model_benchmarks.yml"};
+    std::vector<size_t> sizes;
+
+    for (auto i = 1; i < argc; i++) {
+        const std::string arg{argv[i]};
+        if ((arg == "-c" || arg == "--config") && i + 1 < argc)
+            config_path = argv[++i];
+        else
+            sizes.push_back(std::stoul(arg));
+    }
+
+    if (sizes.empty())
+        sizes = {1000, 10000};
+
+    auto logger = spdlog::stdout_color_mt("clanguml-logger");
+    logger->set_level(spdlog::level::err);
+
+    auto cfg = config::load(config_path);
+
+    std::cout << fmt::format(
+        "{:<44} {:>9} {:>10} {:>12} {:>14} {:>10} {:>10} {:>12}\n",
+        "Benchmark", "Size", "Ops", "Time [ms]", "Ops/s", "Allocs", "Frees",
+        "Bytes");
+
+    for (const auto n : sizes) {
+        run_class_diagram_benchmarks(cfg, n);
+        run_package_diagram_benchmarks(cfg, n);
+        run_sequence_diagram_benchmarks(cfg, n);
+    }
+
+    std::cout << fmt::format("Peak RSS: {:.1f} MB\n",
+        static_cast<double>(common::generators::profiler::peak_rss_kb()) /
+            1024.0);
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#!/usr/bin/python3
+
+##
+## benchmarks/run_benchmarks.py
+##
+## Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+##
+## Licensed under the Apache License, Version 2.0 (the "License");
+## you may not use this file except in compliance with the License.
+## You may obtain a copy of the License at
+##
+##     http://www.apache.org/licenses/LICENSE-2.0
+##
+## Unless required by applicable law or agreed to in writing, software
+## distributed under the License is distributed on an "AS IS" BASIS,
+## WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+## See the License for the specific language governing permissions and
+## limitations under the License.
+##
+
+"""
+Runs clang-uml end to end on a codebase generated by generate_codebase.py.
+
+Each diagram (class, sequence, package and include) is generated in a
+separate clang-uml process with `--profile`, so that the reported peak
+memory usage applies to a single pipeline. For each diagram the script
+reports the median wall time, per phase timings from the profile report,
+throughput in translation units and diagram elements per second and the
+peak resident set size.
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+DIAGRAMS = ['bench_class', 'bench_sequence', 'bench_package', 'bench_include']
+
+
+def count_elements(diagram_json):
+    if 'participants' in diagram_json:
+        return len(diagram_json['participants'])
+
+    def count(elements):
+        result = 0
+        for e in elements:
+            result += 1 + count(e.get('elements', []))
+        return result
+
+    return count(diagram_json.get('elements', []))
+
+
+def run_diagram(args, name):
+    command = [args.clang_uml, '-n', name, '-g', 'json', '-g', 'plantuml',
+               '--profile', '-q', '-t', str(args.threads)]
+
+    start = time.monotonic()
+    subprocess.run(command, cwd=args.codebase, check=True,
+                   stdout=subprocess.DEVNULL)
+    wall_ms = (time.monotonic() - start) * 1000.0
+
+    diagrams_dir = os.path.join(args.codebase, 'diagrams')
+    with open(os.path.join(diagrams_dir, 'clang-uml-profile.json')) as f:
+        profile = json.load(f)
+    with open(os.path.join(diagrams_dir, f'{name}.json')) as f:
+        elements = count_elements(json.load(f))
+
+    return wall_ms, profile, elements
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(
+        description='Run clang-uml benchmarks on a synthetic codebase')
+    parser.add_argument('--clang-uml', required=True,
+                        help='Path to clang-uml binary')
+    parser.add_argument('--codebase', required=True,
+                        help='Directory generated by generate_codebase.py')
+    parser.add_argument('--repeat', type=int, default=3,
+                        help='Number of runs of each diagram')
+    parser.add_argument('--threads', type=int, default=1,
+                        help='Number of threads passed to clang-uml')
+    parser.add_argument('--output', help='Write results to JSON file')
+
+    args = parser.parse_args(argv)
+
+    results = {}
+
+    print(f'{"Diagram":<16} {"wall [ms]":>10} {"clang [ms]":>10} '
+          f'{"final [ms]":>10} {"gen [ms]":>10} {"TU/s":>8} '
+          f'{"elem/s":>10} {"RSS [MB]":>9}')
+
+    for name in DIAGRAMS:
+        runs = [run_diagram(args, name) for _ in range(args.repeat)]
+
+        wall_ms = statistics.median(r[0] for r in runs)
+        diagrams = [r[1]['diagrams'][0] for r in runs]
+        clang_ms = statistics.median(d['clang_ms'] for d in diagrams)
+        finalize_ms = statistics.median(d['finalize_ms'] for d in diagrams)
+        generators_ms = statistics.median(
+            sum(d['generators'].values()) for d in diagrams)
+        peak_rss_kb = max(r[1]['peak_rss_kb'] for r in runs)
+        translation_units = len(diagrams[0]['translation_units'])
+        elements = runs[0][2]
+
+        results[name] = {
+            'wall_ms': wall_ms,
+            'clang_ms': clang_ms,
+            'finalize_ms': finalize_ms,
+            'generators_ms': generators_ms,
+            'translation_units': translation_units,
+            'elements': elements,
+            'translation_units_per_second':
+                translation_units / (wall_ms / 1000.0),
+            'elements_per_second': elements / (wall_ms / 1000.0),
+            'peak_rss_kb': peak_rss_kb}
+
+        r = results[name]
+        print(f'{name:<16} {wall_ms:>10.1f} {clang_ms:>10.1f} '
+              f'{finalize_ms:>10.1f} {generators_ms:>10.1f} '
+              f'{r["translation_units_per_second"]:>8.1f} '
+              f'{r["elements_per_second"]:>10.1f} '
+              f'{peak_rss_kb / 1024.0:>9.1f}')
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
@@ -0,0 +1,329 @@
+/**
+ * @file src/class_diagram/generators/json/partial_model.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_model.h"
+
+#include "common/generators/json/partial_model.h"
+
+namespace clanguml::class_diagram::generators::json {
+
+using namespace clanguml::common::generators::json;
+using clanguml::common::model::access_t;
+using clanguml::common::model::package;
+using model::class_;
+using model::class_element;
+using model::class_member;
+using model::class_method;
+using model::class_parent;
+using model::concept_;
+using model::enum_;
+using model::method_parameter;
+
+namespace {
+void export_class_element(const class_element &e, nlohmann::json &j)
+{
+    j["name"] = e.name();
+    j["type"] = e.type();
+    j["access"] = to_string(e.access());
+
+    export_source_location(e, j);
+    export_decorated_element(e, j);
+}
+
+void import_class_element(const nlohmann::json &j, class_element &e)
+{
+    import_source_location(j, e);
+    import_decorated_element(j, e);
+}
+
+nlohmann::json export_method_parameter(const method_parameter &p)
+{
+    nlohmann::json j{{"name", p.name()}, {"type", p.type()}};
+    if (!p.default_value().empty())
+        j["default_value"] = p.default_value();
+
+    export_decorated_element(p, j);
+
+    return j;
+}
+
+method_parameter import_method_parameter(const nlohmann::json &j)
+{
+    method_parameter p{j.at("type").get<std::string>(),
+        j.at("name").get<std::string>(),
+        j.value("default_value", std::string{})};
+
+    import_decorated_element(j, p);
+
+    return p;
+}
+
+nlohmann::json export_class_member(const class_member &m)
+{
+    nlohmann::json j;
+    export_class_element(m, j);
+    j["is_static"] = m.is_static();
+    if (const auto &multiplicity = m.destination_multiplicity(); multiplicity)
+        j["destination_multiplicity"] = multiplicity.value();
+
+    return j;
+}
+
+class_member import_class_member(const nlohmann::json &j)
+{
+    class_member m{import_access(j.at("access")),
+        j.at("name").get<std::string>(), j.at("type").get<std::string>()};
+    import_class_element(j, m);
+    m.is_static(j.at("is_static").get<bool>());
+    if (j.contains("destination_multiplicity"))
+        m.set_destination_multiplicity(
+            j.at("destination_multiplicity").get<size_t>());
+
+    return m;
+}
+
+nlohmann::json export_class_method(const class_method &m)
+{
+    nlohmann::json j;
+    export_class_element(m, j);
+
+    j["is_pure_virtual"] = m.is_pure_virtual();
+    j["is_virtual"] = m.is_virtual();
+    j["is_const"] = m.is_const();
+    j["is_defaulted"] = m.is_defaulted();
+    j["is_deleted"] = m.is_deleted();
+    j["is_static"] = m.is_static();
+    j["is_noexcept"] = m.is_noexcept();
+    j["is_constexpr"] = m.is_constexpr();
+    j["is_consteval"] = m.is_consteval();
+    j["is_coroutine"] = m.is_coroutine();
+    j["is_constructor"] = m.is_constructor();
+    j["is_destructor"] = m.is_destructor();
+    j["is_move_assignment"] = m.is_move_assignment();
+    j["is_copy_assignment"] = m.is_copy_assignment();
+    j["is_operator"] = m.is_operator();
+    j["template_parameters"] = export_template_parameters(m);
+    j["display_name"] = m.display_name();
+
+    auto parameters = nlohmann::json::array();
+    for (const auto &p : m.parameters())
+        parameters.push_back(export_method_parameter(p));
+    j["parameters"] = std::move(parameters);
+
+    return j;
+}
+
+class_method import_class_method(const nlohmann::json &j)
+{
+    class_method m{import_access(j.at("access")),
+        j.at("name").get<std::string>(), j.at("type").get<std::string>()};
+    import_class_element(j, m);
+
+    m.is_pure_virtual(j.at("is_pure_virtual").get<bool>());
+    m.is_virtual(j.at("is_virtual").get<bool>());
+    m.is_const(j.at("is_const").get<bool>());
+    m.is_defaulted(j.at("is_defaulted").get<bool>());
+    m.is_deleted(j.at("is_deleted").get<bool>());
+    m.is_static(j.at("is_static").get<bool>());
+    m.is_noexcept(j.at("is_noexcept").get<bool>());
+    m.is_constexpr(j.at("is_constexpr").get<bool>());
+    m.is_consteval(j.at("is_consteval").get<bool>());
+    m.is_coroutine(j.at("is_coroutine").get<bool>());
+    m.is_constructor(j.at("is_constructor").get<bool>());
+    m.is_destructor(j.at("is_destructor").get<bool>());
+    m.is_move_assignment(j.at("is_move_assignment").get<bool>());
+    m.is_copy_assignment(j.at("is_copy_assignment").get<bool>());
+    m.is_operator(j.at("is_operator").get<bool>());
+    import_template_parameters(j, m);
+    m.set_display_name(j.at("display_name").get<std::string>());
+
+    for (const auto &p : j.at("parameters"))
+        m.add_parameter(import_method_parameter(p));
+
+    return m;
+}
+
+nlohmann::json export_class_parent(const class_parent &p)
+{
+    return {{"id", export_id(p.id())}, {"name", p.name()},
+        {"is_virtual", p.is_virtual()}, {"access", to_string(p.access())}};
+}
+
+class_parent import_class_parent(const nlohmann::json &j)
+{
+    class_parent p;
+    p.set_id(import_id(j.at("id")));
+    p.set_name(j.at("name").get<std::string>());
+    p.is_virtual(j.at("is_virtual").get<bool>());
+    p.set_access(import_access(j.at("access")));
+
+    return p;
+}
+
+nlohmann::json export_class(const class_ &c)
+{
+    nlohmann::json j;
+    export_element(c, j);
+    export_template_element(c, j);
+    export_style(c, j);
+
+    j["is_struct"] = c.is_struct();
+    j["is_union"] = c.is_union();
+
+    auto members = nlohmann::json::array();
+    for (const auto &m : c.members())
+        members.push_back(export_class_member(m));
+    j["members"] = std::move(members);
+
+    auto methods = nlohmann::json::array();
+    for (const auto &m : c.methods())
+        methods.push_back(export_class_method(m));
+    j["methods"] = std::move(methods);
+
+    auto bases = nlohmann::json::array();
+    for (const auto &p : c.parents())
+        bases.push_back(export_class_parent(p));
+    j["bases"] = std::move(bases);
+
+    return j;
+}
+
+std::unique_ptr<class_> import_class(const nlohmann::json &j)
+{
+    auto c = make_element<class_>(j);
+    import_template_element(j, *c);
+    import_style(j, *c);
+
+    c->is_struct(j.at("is_struct").get<bool>());
+    c->is_union(j.at("is_union").get<bool>());
+
+    for (const auto &m : j.at("members"))
+        c->add_member(import_class_member(m));
+
+    for (const auto &m : j.at("methods"))
+        c->add_method(import_class_method(m));
+
+    for (const auto &p : j.at("bases"))
+        c->add_parent(import_class_parent(p));
+
+    return c;
+}
+
+nlohmann::json export_enum(const enum_ &e)
+{
+    nlohmann::json j;
+    export_element(e, j);
+    export_style(e, j);
+    j["constants"] = e.constants();
+
+    return j;
+}
+
+std::unique_ptr<enum_> import_enum(const nlohmann::json &j)
+{
+    auto e = make_element<enum_>(j);
+    import_style(j, *e);
+    e->constants() = j.at("constants").get<std::vector<std::string>>();
+
+    return e;
+}
+
+nlohmann::json export_concept(const concept_ &c)
+{
+    nlohmann::json j;
+    export_element(c, j);
+    export_style(c, j);
+    j["template_parameters"] = export_template_parameters(c);
+    j["statements"] = c.requires_statements();
+
+    auto parameters = nlohmann::json::array();
+    for (const auto &p : c.requires_parameters())
+        parameters.push_back(export_method_parameter(p));
+    j["parameters"] = std::move(parameters);
+
+    return j;
+}
+
+std::unique_ptr<concept_> import_concept(const nlohmann::json &j)
+{
+    auto c = make_element<concept_>(j);
+    import_style(j, *c);
+    import_template_parameters(j, *c);
+
+    for (const auto &s : j.at("statements"))
+        c->add_statement(s.get<std::string>());
+
+    for (const auto &p : j.at("parameters"))
+        c->add_parameter(import_method_parameter(p));
+
+    return c;
+}
+
+nlohmann::json export_model_element(const common::model::element &e)
+{
+    if (const auto *c = dynamic_cast<const class_ *>(&e); c != nullptr)
+        return export_class(*c);
+
+    if (const auto *en = dynamic_cast<const enum_ *>(&e); en != nullptr)
+        return export_enum(*en);
+
+    if (const auto *c = dynamic_cast<const concept_ *>(&e); c != nullptr)
+        return export_concept(*c);
+
+    if (const auto *p = dynamic_cast<const package *>(&e); p != nullptr)
+        return export_package(*p);
+
+    throw std::runtime_error(
+        fmt::format("Cannot export {} {} to partial model", e.type_name(),
+            e.full_name(false)));
+}
+} // namespace
+
+nlohmann::json export_partial_model(const model::diagram &model)
+{
+    auto elements = nlohmann::json::array();
+    export_elements(model, export_model_element, elements);
+
+    return {{"elements", std::move(elements)}};
+}
+
+void import_partial_models(const std::vector<nlohmann::json> &partial_models,
+    const config::class_diagram &config, model::diagram &model)
+{
+    for (const auto &j : merge_elements(partial_models, "elements")) {
+        const auto type = j.at("type").get<std::string>();
+
+        if (type == "class")
+            add_element(model, j, import_class(j));
+        else if (type == "enum")
+            add_element(model, j, import_enum(j));
+        else if (type == "concept")
+            add_element(model, j, import_concept(j));
+        else if (type == "package")
+            add_element(model, j, import_package(j));
+        else
+            throw std::runtime_error(fmt::format(
+                "Invalid element type '{}' in partial model", type));
+    }
+
+    // Dependencies made redundant by relationships from other shards
+    if (config.skip_redundant_dependencies())
+        model.remove_redundant_dependencies();
+}
+
+} // namespace clanguml::class_diagram::generators::json
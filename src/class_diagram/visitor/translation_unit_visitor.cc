@@ -42,6 +42,20 @@ std::unique_ptr<class_> translation_unit_visitor::create_element(
     return cls;
 }
 
+bool translation_unit_visitor::TraverseNamespaceDecl(clang::NamespaceDecl *ns)
+{
+    assert(ns != nullptr);
+
+    // Skip entire namespaces from system headers or excluded by the
+    // diagram filters, as none of their declarations can be included
+    if (source_manager().isInSystemHeader(ns->getLocation()) ||
+        is_namespace_excluded(*ns))
+        return true;
+
+    return RecursiveASTVisitor<translation_unit_visitor>::TraverseNamespaceDecl(
+        ns);
+}
+
 bool translation_unit_visitor::VisitNamespaceDecl(clang::NamespaceDecl *ns)
 {
     assert(ns != nullptr);
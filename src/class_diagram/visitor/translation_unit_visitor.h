@@ -25,6 +25,7 @@
 #include "common/visitor/template_builder.h"
 #include "common/visitor/translation_unit_visitor.h"
 #include "config/config.h"
+#include "util/flat_hash_map.h"
 
 #include <clang/AST/RecursiveASTVisitor.h>
 #include <clang/Basic/SourceManager.h>
@@ -93,6 +94,8 @@ public:
 
     bool shouldVisitImplicitCode() const { return false; }
 
+    virtual bool TraverseNamespaceDecl(clang::NamespaceDecl *ns);
+
     virtual bool VisitNamespaceDecl(clang::NamespaceDecl *ns);
 
     virtual bool VisitRecordDecl(clang::RecordDecl *D);
@@ -436,7 +439,7 @@ private:
     std::map<eid_t, std::unique_ptr<clanguml::class_diagram::model::class_>>
         forward_declarations_;
 
-    std::map<int64_t /* local anonymous struct id */,
+    util::flat_hash_map<int64_t /* local anonymous struct id */,
         std::tuple<std::string /* field name */, common::model::relationship_t,
             common::model::access_t,
             std::optional<size_t> /* destination_multiplicity */>>
@@ -28,6 +28,10 @@
 #include <clang/Config/config.h>
 #include <indicators/indicators.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
 namespace clanguml::cli {
 cli_handler::cli_handler(
     std::ostream &ostr, std::shared_ptr<spdlog::logger> logger)
@@ -38,19 +42,15 @@ cli_handler::cli_handler(
 
 void cli_handler::setup_logging()
 {
-    spdlog::drop("clanguml-logger");
-
-    if (!progress) {
-        spdlog::register_logger(logger_);
-    }
-    else {
+    if (progress) {
         // Setup null logger for clean progress indicators
         std::vector<spdlog::sink_ptr> sinks;
         logger_ = std::make_shared<spdlog::logger>(
             "clanguml-logger", begin(sinks), end(sinks));
-        spdlog::register_logger(logger_);
     }
 
+    util::register_logger(logger_);
+
     logger_->set_pattern("[%^%l%^] [tid %t] %v");
 
     if (verbose == 0) {
@@ -142,6 +142,39 @@ cli_flow_t cli_handler::parse(int argc, const char **argv)
         "Perform configuration file schema validation and exit");
     app.add_flag("-r,--render_diagrams", render_diagrams,
         "Automatically render generated diagrams using appropriate command");
+    app.add_option("--render-batch-size", render_batch_size,
+        "Maximum number of diagrams rendered by a single render command "
+        "invocation (default: 1)");
+    app.add_option("--render-jobs", render_jobs,
+        "Maximum number of render commands running in parallel "
+        "(0 = hardware concurrency)");
+    app.add_flag("--profile", profile,
+        "Print timings of diagram generation phases and write them to "
+        "clang-uml-profile.json in the output directory");
+    app.add_option("--trace-file", trace_file,
+        "Write Chrome trace events of diagram generation to a JSON file, "
+        "which can be opened in chrome://tracing or Perfetto");
+    app.add_option("--memory-limit", memory_limit,
+        "Do not start new translation units while memory usage exceeds the "
+        "limit in MB (0 = unlimited)");
+    app.add_flag("--incremental", incremental,
+        "Skip diagrams whose configuration, compile commands and source files "
+        "have not changed since the previous run");
+    app.add_flag("--watch", watch,
+        "Keep running and regenerate diagrams affected by changes to source "
+        "files, configuration file or compilation database");
+#if !defined(_WIN32)
+    app.add_option("--daemon", daemon_socket,
+        "Keep running and serve diagram generation requests on a Unix domain "
+        "socket at the given path");
+#endif
+    app.add_option("--shard", shard,
+        "Process only a subset of translation units, in the form 'i/N', and "
+        "write partial models of diagrams to the output directory instead of "
+        "generating them (only include diagrams are supported)");
+    auto *merge_command = app.add_subcommand("merge",
+        "Merge partial models written by all shards and generate diagrams");
+    merge_command->fallthrough();
     app.add_option("--plantuml-cmd", plantuml_cmd,
         "Command template to render PlantUML diagram, `{}` will be replaced "
         "with diagram name.");
@@ -162,6 +195,8 @@ cli_flow_t cli_handler::parse(int argc, const char **argv)
         exit(app.exit(e)); // NOLINT(concurrency-mt-unsafe)
     }
 
+    merge = merge_command->parsed();
+
     if (quiet || dump_config || print_from || print_to)
         verbose = 0;
     else
@@ -199,6 +234,23 @@ cli_flow_t cli_handler::handle_options(int argc, const char **argv)
     return res;
 }
 
+cli_flow_t cli_handler::reload_config()
+{
+    // Paths could have been moved or replaced with symbolic links
+    util::clear_weakly_canonical_cache();
+
+    auto res = load_config();
+
+    if (res != cli_flow_t::kContinue)
+        return res;
+
+    res = handle_post_config_options();
+
+    config.inherit();
+
+    return res;
+}
+
 cli_flow_t cli_handler::handle_pre_config_options()
 {
     if (show_version) {
@@ -226,6 +278,69 @@ cli_flow_t cli_handler::handle_pre_config_options()
         }
     }
 
+    if (watch && daemon_socket) {
+        LOG_ERROR("ERROR: '--watch' cannot be used with '--daemon'");
+
+        return cli_flow_t::kError;
+    }
+
+    if (incremental && (watch || daemon_socket)) {
+        LOG_ERROR("ERROR: '--incremental' cannot be used with '--watch' or "
+                  "'--daemon'");
+
+        return cli_flow_t::kError;
+    }
+
+    if (shard) {
+        // std::stoul() accepts signs and trailing characters, and its result
+        // may not fit in unsigned int
+        auto parse_number = [](const std::string &number) {
+            if (number.empty() ||
+                !std::all_of(number.begin(), number.end(),
+                    [](unsigned char c) { return std::isdigit(c) != 0; }))
+                throw std::invalid_argument{number};
+
+            const auto value = std::stoul(number);
+            if (value > std::numeric_limits<unsigned int>::max())
+                throw std::out_of_range{number};
+
+            return static_cast<unsigned int>(value);
+        };
+
+        const auto separator = shard->find('/');
+        try {
+            if (separator == std::string::npos)
+                throw std::invalid_argument{*shard};
+
+            shard_index = parse_number(shard->substr(0, separator));
+            shard_count = parse_number(shard->substr(separator + 1));
+        }
+        catch (const std::exception &) {
+            shard_count = 0;
+        }
+
+        if (shard_count == 0 || shard_index == 0 || shard_index > shard_count) {
+            LOG_ERROR("ERROR: Invalid shard '{}', expected 'i/N' where "
+                      "1 <= i <= N",
+                *shard);
+
+            return cli_flow_t::kError;
+        }
+
+        if (merge) {
+            LOG_ERROR("ERROR: '--shard' cannot be used with 'merge'");
+
+            return cli_flow_t::kError;
+        }
+
+        if (watch || daemon_socket || incremental) {
+            LOG_ERROR("ERROR: '--shard' cannot be used with '--watch', "
+                      "'--daemon' or '--incremental'");
+
+            return cli_flow_t::kError;
+        }
+    }
+
     if (initialize) {
         return create_config_file();
     }
@@ -273,7 +388,7 @@ cli_flow_t cli_handler::load_config()
         return cli_flow_t::kContinue;
     }
     catch (std::runtime_error &e) {
-        LOG_ERROR(e.what());
+        LOG_ERROR("{}", e.what());
     }
 
     return cli_flow_t::kError;
@@ -383,6 +498,14 @@ runtime_config cli_handler::get_runtime_config() const
     cfg.progress = progress;
     cfg.thread_count = thread_count;
     cfg.render_diagrams = render_diagrams;
+    cfg.render_batch_size = render_batch_size;
+    cfg.render_jobs = render_jobs;
+    cfg.profile = profile;
+    cfg.trace_file = trace_file;
+    cfg.memory_limit = memory_limit;
+    cfg.incremental = incremental;
+    cfg.shard_index = shard_index;
+    cfg.shard_count = shard_count;
     cfg.output_directory = effective_output_directory;
 
     return cfg;
@@ -38,6 +38,14 @@ struct runtime_config {
     bool progress{};
     unsigned int thread_count{};
     bool render_diagrams{};
+    unsigned int render_batch_size{};
+    unsigned int render_jobs{};
+    bool profile{};
+    std::optional<std::string> trace_file{};
+    unsigned int memory_limit{};
+    bool incremental{};
+    unsigned int shard_index{};
+    unsigned int shard_count{};
     std::string output_directory{};
 };
 
@@ -73,6 +81,14 @@ public:
      */
     cli_flow_t handle_options(int argc, const char **argv);
 
+    /**
+     * Load the configuration file again and apply command line overrides,
+     * e.g. after the file has been modified in watch mode.
+     *
+     * @return Command line handler state
+     */
+    cli_flow_t reload_config();
+
     /**
      * Print the program version and basic information
      *
@@ -189,6 +205,19 @@ public:
     bool no_validate{false};
     bool validate_only{false};
     bool render_diagrams{false};
+    unsigned int render_batch_size{1};
+    unsigned int render_jobs{};
+    bool profile{false};
+    std::optional<std::string> trace_file;
+    unsigned int memory_limit{0};
+    bool watch{false};
+    bool incremental{false};
+    // Only set on platforms supporting the '--daemon' option
+    std::optional<std::string> daemon_socket;
+    std::optional<std::string> shard;
+    unsigned int shard_index{0};
+    unsigned int shard_count{0};
+    bool merge{false};
     std::optional<std::string> plantuml_cmd;
     std::optional<std::string> mermaid_cmd;
 
@@ -136,8 +136,11 @@ std::string to_string(const clang::ArrayType &array_type,
         "{}{}", to_string(underlying_type, ctx, try_canonical), dimensions_str);
 }
 
-std::string to_string(const clang::QualType &type, const clang::ASTContext &ctx,
-    bool try_canonical)
+namespace {
+thread_local type_name_cache *current_type_name_cache{nullptr};
+
+std::string type_to_string(const clang::QualType &type,
+    const clang::ASTContext &ctx, bool try_canonical)
 {
     if (type->isArrayType()) {
         std::vector<std::string> dimensions;
@@ -220,6 +223,38 @@ std::string to_string(const clang::QualType &type, const clang::ASTContext &ctx,
     return result;
 }
 
+template <typename T> eid_t decl_to_id(const T &declaration)
+{
+    auto *cache = type_name_cache::current();
+    if (cache == nullptr)
+        return to_id(get_qualified_name(declaration));
+
+    return cache->decl_id(&declaration,
+        [&declaration]() { return to_id(get_qualified_name(declaration)); });
+}
+} // namespace
+
+type_name_cache::type_name_cache()
+    : previous_{current_type_name_cache}
+{
+    current_type_name_cache = this;
+}
+
+type_name_cache::~type_name_cache() { current_type_name_cache = previous_; }
+
+type_name_cache *type_name_cache::current() { return current_type_name_cache; }
+
+std::string to_string(const clang::QualType &type, const clang::ASTContext &ctx,
+    bool try_canonical)
+{
+    auto *cache = type_name_cache::current();
+    if (cache == nullptr)
+        return type_to_string(type, ctx, try_canonical);
+
+    return cache->type_name(type, try_canonical,
+        [&]() { return type_to_string(type, ctx, try_canonical); });
+}
+
 std::string to_string(const clang::RecordType &type,
     const clang::ASTContext &ctx, bool try_canonical)
 {
@@ -417,38 +452,42 @@ bool is_subexpr_of(const clang::Stmt *parent_stmt, const clang::Stmt *sub_stmt)
 
 template <> eid_t to_id(const std::string &full_name)
 {
-    return static_cast<eid_t>(
-        static_cast<uint64_t>(std::hash<std::string>{}(full_name)));
+    return static_cast<eid_t>(util::stable_hash(full_name));
 }
 
 eid_t to_id(const clang::QualType &type, const clang::ASTContext &ctx)
 {
-    return to_id(common::to_string(type, ctx));
+    auto *cache = type_name_cache::current();
+    if (cache == nullptr)
+        return to_id(common::to_string(type, ctx));
+
+    return cache->type_id(
+        type, [&]() { return to_id(common::to_string(type, ctx)); });
 }
 
 template <> eid_t to_id(const clang::NamespaceDecl &declaration)
 {
-    return to_id(get_qualified_name(declaration));
+    return decl_to_id(declaration);
 }
 
 template <> eid_t to_id(const clang::RecordDecl &declaration)
 {
-    return to_id(get_qualified_name(declaration));
+    return decl_to_id(declaration);
 }
 
 template <> eid_t to_id(const clang::EnumDecl &declaration)
 {
-    return to_id(get_qualified_name(declaration));
+    return decl_to_id(declaration);
 }
 
 template <> eid_t to_id(const clang::TagDecl &declaration)
 {
-    return to_id(get_qualified_name(declaration));
+    return decl_to_id(declaration);
 }
 
 template <> eid_t to_id(const clang::CXXRecordDecl &declaration)
 {
-    return to_id(get_qualified_name(declaration));
+    return decl_to_id(declaration);
 }
 
 template <> eid_t to_id(const clang::EnumType &t)
@@ -727,10 +766,10 @@ clang::QualType dereference(clang::QualType type)
     return res;
 }
 
-std::pair<clang::QualType, std::deque<common::model::context>>
+std::pair<clang::QualType, std::vector<common::model::context>>
 consume_type_context(clang::QualType type)
 {
-    std::deque<common::model::context> res;
+    std::vector<common::model::context> res;
 
     while (true) {
         bool try_again{false};
@@ -808,7 +847,7 @@ consume_type_context(clang::QualType type)
                 type = type.getUnqualifiedType();
             }
 
-            res.push_front(ctx);
+            res.insert(res.begin(), ctx);
 
             if (type->isMemberFunctionPointerType())
                 return std::make_pair(type, res);
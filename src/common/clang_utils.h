@@ -27,9 +27,11 @@
 #include <clang/AST/Expr.h>
 #include <clang/AST/RecursiveASTVisitor.h>
 
+#include <array>
 #include <deque>
 #include <filesystem>
 #include <string>
+#include <unordered_map>
 
 namespace clang {
 class NamespaceDecl;
@@ -169,6 +171,95 @@ void ensure_lambda_type_is_relative(
  */
 bool is_subexpr_of(const clang::Stmt *parent_stmt, const clang::Stmt *sub_stmt);
 
+/**
+ * @brief Per translation unit cache of type names and element ids
+ *
+ * The same types and declarations are converted to names and ids many times
+ * while processing a translation unit (e.g. for each field, parameter and
+ * template argument). While an instance of this class is alive, it is used
+ * on the current thread by `to_string(const clang::QualType &, ...)`,
+ * `to_id(const clang::QualType &, ...)` and `to_id()` of declarations.
+ *
+ * The cache is keyed on AST node pointers, so it must not outlive the
+ * translation unit AST.
+ */
+class type_name_cache {
+public:
+    type_name_cache();
+
+    type_name_cache(const type_name_cache &) = delete;
+    type_name_cache(type_name_cache &&) = delete;
+    type_name_cache &operator=(const type_name_cache &) = delete;
+    type_name_cache &operator=(type_name_cache &&) = delete;
+
+    ~type_name_cache();
+
+    /**
+     * @brief Get the cache used by the current thread
+     *
+     * @return Current cache or nullptr if caching is not enabled
+     */
+    static type_name_cache *current();
+
+    /**
+     * @brief Get the cached type name or calculate it
+     *
+     * The key is the type including its sugar and qualifiers, as they affect
+     * the printed name.
+     *
+     * @param type Type
+     * @param try_canonical Flag passed to `to_string()`
+     * @param f Function calculating the type name on cache miss
+     * @return Reference to the cached type name
+     */
+    template <typename F>
+    const std::string &type_name(
+        const clang::QualType &type, bool try_canonical, F &&f)
+    {
+        auto &names = type_names_[try_canonical ? 1 : 0];
+        auto it = names.find(type.getAsOpaquePtr());
+        if (it == names.end())
+            it = names.emplace(type.getAsOpaquePtr(), f()).first;
+        return it->second;
+    }
+
+    /**
+     * @brief Get the cached id of a type or calculate it
+     *
+     * @param type Type
+     * @param f Function calculating the id on cache miss
+     * @return Type id
+     */
+    template <typename F> eid_t type_id(const clang::QualType &type, F &&f)
+    {
+        auto it = type_ids_.find(type.getAsOpaquePtr());
+        if (it == type_ids_.end())
+            it = type_ids_.emplace(type.getAsOpaquePtr(), f()).first;
+        return it->second;
+    }
+
+    /**
+     * @brief Get the cached id of a declaration or calculate it
+     *
+     * @param decl Declaration
+     * @param f Function calculating the id on cache miss
+     * @return Declaration id
+     */
+    template <typename F> eid_t decl_id(const clang::Decl *decl, F &&f)
+    {
+        auto it = decl_ids_.find(decl);
+        if (it == decl_ids_.end())
+            it = decl_ids_.emplace(decl, f()).first;
+        return it->second;
+    }
+
+private:
+    type_name_cache *previous_;
+    std::array<std::unordered_map<const void *, std::string>, 2> type_names_;
+    std::unordered_map<const void *, eid_t> type_ids_;
+    std::unordered_map<const clang::Decl *, eid_t> decl_ids_;
+};
+
 /** @defgroup to_id Forward template for convertions to ID from various entities
  *
  * These methods provide the main mechanism for generating globally unique
@@ -285,7 +376,7 @@ clang::QualType dereference(clang::QualType type);
  * @param type Type to process
  * @return (type, [qualifiers])
  */
-std::pair<clang::QualType, std::deque<common::model::context>>
+std::pair<clang::QualType, std::vector<common::model::context>>
 consume_type_context(clang::QualType type);
 
 /**
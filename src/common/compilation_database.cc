@@ -103,9 +103,16 @@ long compilation_database::count_matching_commands(
     return result;
 }
 
+std::chrono::nanoseconds compilation_database::adjustment_time() const
+{
+    return std::chrono::nanoseconds{adjustment_time_ns_.load()};
+}
+
 void compilation_database::adjust_compilation_database(
     std::vector<clang::tooling::CompileCommand> &commands) const
 {
+    const auto start = std::chrono::steady_clock::now();
+
 #if !defined(_WIN32)
     if (config().query_driver && !config().query_driver().empty()) {
         for (auto &compile_command : commands) {
@@ -156,6 +163,10 @@ void compilation_database::adjust_compilation_database(
             }
         }
     }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    adjustment_time_ns_ +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
 }
 
 } // namespace clanguml::common
\ No newline at end of file
@@ -29,6 +29,8 @@
 #include <clang/Tooling/CompilationDatabase.h>
 #include <clang/Tooling/Tooling.h>
 
+#include <atomic>
+#include <chrono>
 #include <deque>
 #include <filesystem>
 #include <string>
@@ -105,6 +107,14 @@ public:
 
     long count_matching_commands(const std::vector<std::string> &files) const;
 
+    /**
+     * Returns the total time spent adjusting compile commands, e.g. querying
+     * the compiler driver for system include paths.
+     *
+     * @return Total adjustment time from all threads
+     */
+    std::chrono::nanoseconds adjustment_time() const;
+
 private:
     void adjust_compilation_database(
         std::vector<clang::tooling::CompileCommand> &commands) const;
@@ -121,6 +131,11 @@ private:
      * Reference to the instance of clanguml config.
      */
     const clanguml::config::config &config_;
+
+    /*!
+     * Total time spent in adjust_compilation_database() in nanoseconds.
+     */
+    mutable std::atomic<std::int64_t> adjustment_time_ns_{0};
 };
 
 using compilation_database_ptr = std::unique_ptr<compilation_database>;
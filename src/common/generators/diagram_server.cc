@@ -0,0 +1,406 @@
+/**
+ * @file src/common/generators/diagram_server.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "diagram_server.h"
+
+#include "generators.h"
+#include "util/util.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <future>
+#include <list>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace clanguml::common::generators {
+
+namespace {
+// Interval in which blocked threads check whether the server is stopping
+constexpr int kPollIntervalMs{200};
+
+std::optional<generator_type_t> generator_type_from_string(
+    const std::string &name)
+{
+    for (const auto generator_type : {generator_type_t::plantuml,
+             generator_type_t::json, generator_type_t::mermaid}) {
+        if (to_string(generator_type) == name)
+            return generator_type;
+    }
+
+    return {};
+}
+
+nlohmann::json error_response(const std::string &message)
+{
+    return {{"status", "error"}, {"error", message}};
+}
+
+#if !defined(_WIN32)
+std::string last_error_message()
+{
+    return std::error_code{errno, std::generic_category()}.message();
+}
+
+/**
+ * Remove socket file left by a previous server instance, refusing to
+ * remove any other kind of file
+ */
+void remove_stale_socket(const std::string &socket_path)
+{
+    struct stat st {};
+    if (lstat(socket_path.c_str(), &st) != 0) {
+        if (errno == ENOENT)
+            return;
+
+        throw std::runtime_error(fmt::format(
+            "Cannot access {}: {}", socket_path, last_error_message()));
+    }
+
+    if (!S_ISSOCK(st.st_mode))
+        throw std::runtime_error(fmt::format(
+            "Refusing to replace {}, which is not a socket", socket_path));
+
+    if (unlink(socket_path.c_str()) != 0)
+        throw std::runtime_error(fmt::format("Failed to remove socket {}: {}",
+            socket_path, last_error_message()));
+}
+
+bool write_all(int fd, const std::string &data)
+{
+    std::size_t written{0};
+    while (written < data.size()) {
+        const auto res =
+            write(fd, data.data() + written, data.size() - written);
+        if (res < 0 && errno == EINTR)
+            continue;
+
+        if (res <= 0)
+            return false;
+
+        written += static_cast<std::size_t>(res);
+    }
+
+    return true;
+}
+
+bool write_response(int fd, const nlohmann::json &response)
+{
+    // Diagram comments are not guaranteed to be valid UTF-8
+    return write_all(fd,
+        response.dump(
+            -1, ' ', false, nlohmann::json::error_handler_t::replace) +
+            '\n');
+}
+#endif
+} // namespace
+
+diagram_server::diagram_server(clanguml::config::config &config,
+    const common::compilation_database &db,
+    const cli::runtime_config &runtime_config,
+    std::map<std::string, std::vector<std::string>> translation_units_map)
+    : config_{config}
+    , db_{db}
+    , runtime_config_{runtime_config}
+    , translation_units_map_{std::move(translation_units_map)}
+{
+}
+
+void diagram_server::run(const std::string &socket_path)
+{
+#if defined(_WIN32)
+    throw std::runtime_error("Daemon mode is not supported on Windows");
+#else
+    // Clients disconnecting before reading their response must not
+    // terminate the server
+    std::signal(SIGPIPE, SIG_IGN); // NOLINT
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error(
+            fmt::format("Socket path {} is too long", socket_path));
+
+    std::copy(socket_path.begin(), socket_path.end(), address.sun_path);
+
+    remove_stale_socket(socket_path);
+
+    const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+        throw std::runtime_error("Failed to create socket");
+
+    // Only the owner can connect to the socket, as requests can read any
+    // file accessible to the server
+    const auto previous_umask = umask(S_IRWXG | S_IRWXO);
+    const auto bind_res = bind(
+        listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    umask(previous_umask);
+
+    if (bind_res != 0 || listen(listen_fd, SOMAXCONN) != 0) {
+        close(listen_fd);
+        throw std::runtime_error(
+            fmt::format("Failed to listen on socket {}", socket_path));
+    }
+
+    LOG_INFO("Listening for requests on {}", socket_path);
+
+    {
+        util::thread_pool_executor executor{runtime_config_.thread_count};
+
+        // Each connection is served by its own thread, so that idle clients
+        // do not occupy the thread pool, which only generates the diagrams
+        std::list<std::future<void>> connections;
+
+        while (!stop_) {
+            connections.remove_if([](const auto &connection) {
+                return connection.wait_for(std::chrono::seconds{0}) ==
+                    std::future_status::ready;
+            });
+
+            pollfd pfd{listen_fd, POLLIN, 0};
+            if (poll(&pfd, 1, kPollIntervalMs) <= 0)
+                continue;
+
+            const int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+
+            if (connections.size() >= kMaxConnections) {
+                LOG_WARN("Rejecting connection - {} clients are connected",
+                    connections.size());
+                write_response(fd,
+                    error_response(fmt::format(
+                        "Too many connections, the limit is {}",
+                        kMaxConnections)));
+                close(fd);
+                continue;
+            }
+
+            connections.emplace_back(
+                std::async(std::launch::async, [this, fd, &executor]() {
+                    handle_connection(fd, executor);
+                }));
+        }
+    }
+
+    close(listen_fd);
+    unlink(socket_path.c_str());
+
+    LOG_INFO("Server stopped");
+#endif
+}
+
+#if !defined(_WIN32)
+void diagram_server::handle_connection(
+    int fd, util::thread_pool_executor &executor)
+{
+    std::string buffer;
+    std::array<char, 4096> chunk{};
+
+    while (!stop_) {
+        pollfd pfd{fd, POLLIN, 0};
+        const auto res = poll(&pfd, 1, kPollIntervalMs);
+        if (res == 0 || (res < 0 && errno == EINTR))
+            continue;
+
+        if (res < 0)
+            break;
+
+        const auto length = read(fd, chunk.data(), chunk.size());
+        if (length <= 0)
+            break;
+
+        buffer.append(chunk.data(), static_cast<std::size_t>(length));
+
+        auto eol = buffer.find('\n');
+        while (eol != std::string::npos) {
+            const auto line = buffer.substr(0, eol);
+            buffer.erase(0, eol + 1);
+            eol = buffer.find('\n');
+
+            if (util::trim(line).empty())
+                continue;
+
+            nlohmann::json response;
+            try {
+                const auto request = nlohmann::json::parse(line);
+                executor
+                    .add([this, &request, &response]() {
+                        response = handle_request(request);
+                    })
+                    .get();
+            }
+            catch (const nlohmann::json::parse_error &e) {
+                response = error_response(e.what());
+            }
+
+            if (!write_response(fd, response)) {
+                close(fd);
+                return;
+            }
+        }
+
+        // The rest of the buffer is an incomplete request
+        if (buffer.size() > kMaxRequestLength) {
+            write_response(fd,
+                error_response(fmt::format(
+                    "Request exceeds the limit of {} bytes",
+                    kMaxRequestLength)));
+            break;
+        }
+    }
+
+    close(fd);
+}
+#endif
+
+nlohmann::json diagram_server::handle_request(const nlohmann::json &request)
+{
+    try {
+        const auto command =
+            request.value("command", std::string{"generate"});
+
+        if (command == "list")
+            return list_diagrams();
+
+        if (command == "shutdown") {
+            stop_ = true;
+            return {{"status", "ok"}};
+        }
+
+        if (command != "generate")
+            return error_response(fmt::format("Unknown command {}", command));
+
+        const auto diagram_name = request.at("diagram").get<std::string>();
+
+        auto generator_type = runtime_config_.generators.empty()
+            ? generator_type_t::plantuml
+            : runtime_config_.generators.front();
+
+        if (request.contains("generator")) {
+            const auto generator_name =
+                request.at("generator").get<std::string>();
+            const auto requested_type =
+                generator_type_from_string(generator_name);
+            if (!requested_type)
+                return error_response(
+                    fmt::format("Unknown generator {}", generator_name));
+
+            generator_type = *requested_type;
+        }
+
+        return generate(diagram_name, generator_type);
+    }
+    catch (const std::exception &e) {
+        return error_response(e.what());
+    }
+}
+
+nlohmann::json diagram_server::generate(
+    const std::string &diagram_name, generator_type_t generator_type)
+{
+    const auto diagram = config_.diagrams.find(diagram_name);
+    if (diagram == config_.diagrams.end())
+        return error_response(fmt::format("Unknown diagram {}", diagram_name));
+
+    const auto translation_units = translation_units_map_.find(diagram_name);
+    if (translation_units == translation_units_map_.end() ||
+        translation_units->second.empty())
+        return error_response(fmt::format(
+            "No translation units found for diagram {}", diagram_name));
+
+    auto cached = get_cached_model(diagram_name);
+
+    // Concurrent requests for the same diagram wait for the model to be
+    // generated only once
+    std::lock_guard<std::mutex> l{cached->mutex};
+
+    const auto is_cached = cached->model && is_up_to_date(*cached);
+
+    if (!is_cached) {
+        LOG_INFO("Generating model of diagram {}", diagram_name);
+
+        // Release the outdated model before generating a new one
+        cached->model.reset();
+        cached->dependencies.clear();
+
+        std::set<std::string> dependencies;
+        cached->model = generate_diagram_model(diagram->second, db_,
+            translation_units->second, &dependencies);
+
+        for (const auto &dependency : dependencies) {
+            std::error_code ec;
+            cached->dependencies.emplace(
+                dependency, std::filesystem::last_write_time(dependency, ec));
+        }
+    }
+
+    return {{"status", "ok"}, {"diagram", diagram_name},
+        {"generator", to_string(generator_type)}, {"cached", is_cached},
+        {"output",
+            generate_diagram_output(
+                generator_type, *diagram->second, *cached->model)}};
+}
+
+nlohmann::json diagram_server::list_diagrams() const
+{
+    auto diagrams = nlohmann::json::array();
+    for (const auto &[name, diagram] : config_.diagrams) {
+        diagrams.push_back(
+            {{"name", name}, {"type", to_string(diagram->type())}});
+    }
+
+    return {{"status", "ok"}, {"diagrams", std::move(diagrams)}};
+}
+
+std::shared_ptr<diagram_server::cached_model> diagram_server::get_cached_model(
+    const std::string &diagram_name)
+{
+    std::lock_guard<std::mutex> l{models_mutex_};
+
+    auto &cached = models_[diagram_name];
+    if (!cached)
+        cached = std::make_shared<cached_model>();
+
+    return cached;
+}
+
+bool diagram_server::is_up_to_date(const cached_model &cached)
+{
+    return std::all_of(cached.dependencies.begin(), cached.dependencies.end(),
+        [](const auto &dependency) {
+            std::error_code ec;
+            return std::filesystem::last_write_time(dependency.first, ec) ==
+                dependency.second;
+        });
+}
+
+} // namespace clanguml::common::generators
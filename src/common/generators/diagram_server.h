@@ -0,0 +1,137 @@
+/**
+ * @file src/common/generators/diagram_server.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "cli/cli_handler.h"
+#include "common/compilation_database.h"
+#include "common/model/diagram.h"
+#include "config/config.h"
+#include "util/thread_pool_executor.h"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Serves diagram generation requests over a Unix domain socket
+ *
+ * The server keeps the configuration, the compilation database and the
+ * models of already generated diagrams in memory. A cached model is reused
+ * until any of the files it was generated from is modified, so repeated
+ * requests for the same diagram only run the requested generator.
+ *
+ * Each client connection is served by a dedicated thread, while the
+ * requests are handled on the thread pool. The socket is only accessible to
+ * the user running the server. Requests and responses are JSON objects, one
+ * per line, e.g.:
+ *
+ * @code
+ * {"command": "generate", "diagram": "main_class", "generator": "plantuml"}
+ * {"status": "ok", "diagram": "main_class", "generator": "plantuml",
+ *  "cached": true, "output": "@startuml..."}
+ * @endcode
+ *
+ * Other supported commands are `list`, which returns the names and types of
+ * the diagrams, and `shutdown`, which stops the server.
+ *
+ * Clients connecting above @ref kMaxConnections and requests longer than
+ * @ref kMaxRequestLength receive an error response and are disconnected.
+ */
+class diagram_server {
+public:
+    /*! Maximum number of clients connected at the same time */
+    static constexpr std::size_t kMaxConnections{64};
+
+    /*! Maximum length of a single request line in bytes */
+    static constexpr std::size_t kMaxRequestLength{1024 * 1024};
+
+    /**
+     * @brief Constructor
+     *
+     * @param config Reference to config instance
+     * @param db Reference to compilation database
+     * @param runtime_config Runtime configuration
+     * @param translation_units_map Map of translation units for each diagram
+     */
+    diagram_server(clanguml::config::config &config,
+        const common::compilation_database &db,
+        const cli::runtime_config &runtime_config,
+        std::map<std::string, std::vector<std::string>> translation_units_map);
+
+    /**
+     * @brief Accept and handle client connections until `shutdown` command
+     *        is received
+     *
+     * Throws `std::runtime_error` if the socket path exists and is not
+     * a socket.
+     *
+     * @param socket_path Path of the Unix domain socket to listen on
+     */
+    void run(const std::string &socket_path);
+
+    /**
+     * @brief Handle a single request
+     *
+     * @param request Request object
+     * @return Response object
+     */
+    nlohmann::json handle_request(const nlohmann::json &request);
+
+private:
+    /**
+     * Diagram model cached along with modification times of the files it
+     * was generated from
+     */
+    struct cached_model {
+        std::mutex mutex;
+        std::unique_ptr<model::diagram> model;
+        std::map<std::string, std::filesystem::file_time_type> dependencies;
+    };
+
+    void handle_connection(int fd, util::thread_pool_executor &executor);
+
+    nlohmann::json generate(
+        const std::string &diagram_name, generator_type_t generator_type);
+
+    nlohmann::json list_diagrams() const;
+
+    std::shared_ptr<cached_model> get_cached_model(
+        const std::string &diagram_name);
+
+    static bool is_up_to_date(const cached_model &cached);
+
+    clanguml::config::config &config_;
+    const common::compilation_database &db_;
+    cli::runtime_config runtime_config_;
+    std::map<std::string, std::vector<std::string>> translation_units_map_;
+
+    std::mutex models_mutex_;
+    std::map<std::string, std::shared_ptr<cached_model>> models_;
+
+    std::atomic_bool stop_{false};
+};
+
+} // namespace clanguml::common::generators
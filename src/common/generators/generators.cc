@@ -18,7 +18,11 @@
 
 #include "generators.h"
 
+#include "manifest.h"
+#include "memory_budget.h"
 #include "progress_indicator.h"
+#include "render_queue.h"
+#include "shard.h"
 
 namespace clanguml::common::generators {
 void find_translation_units_for_diagrams(
@@ -57,76 +61,93 @@ void find_translation_units_for_diagrams(
     }
 }
 
-void render_diagram(const clanguml::common::generator_type_t generator_type,
-    std::shared_ptr<config::diagram> diagram_config)
+namespace {
+std::string generator_extension(generator_type_t generator_type)
 {
-    std::string cmd;
-    switch (generator_type) {
-    case clanguml::common::generator_type_t::plantuml:
-        cmd = diagram_config->puml().cmd;
-        break;
-    case clanguml::common::generator_type_t::mermaid:
-        cmd = diagram_config->mermaid().cmd;
-        break;
-    default:
-        return;
-    };
+    if (generator_type == generator_type_t::json)
+        return json_generator_tag::extension;
 
-    if (cmd.empty())
-        throw std::runtime_error(
-            fmt::format("No render command template provided for {} diagrams",
-                to_string(diagram_config->type())));
+    if (generator_type == generator_type_t::mermaid)
+        return mermaid_generator_tag::extension;
+
+    return plantuml_generator_tag::extension;
+}
+
+bool write_diagram_output(const std::string &od, const std::string &name,
+    const std::string &extension, const std::string &output)
+{
+    auto path =
+        std::filesystem::path{od} / fmt::format("{}.{}", name, extension);
+
+    // Keep the modification time of unchanged files, so that they do not
+    // trigger rebuilds of anything depending on them
+    if (util::file_content_equals(path, output)) {
+        LOG_INFO("Diagram {} in {} has not changed", name, path.string());
+        return false;
+    }
 
-    util::replace_all(cmd, "{}", diagram_config->name);
+    std::ofstream ofs;
+    ofs.open(path, std::ofstream::out | std::ofstream::trunc);
+    ofs << output;
 
-    LOG_INFO("Rendering diagram {} using {}", diagram_config->name,
-        to_string(generator_type));
+    ofs.close();
 
-    util::check_process_output(cmd);
+    LOG_INFO("Written {} diagram to {}", name, path.string());
+
+    return true;
 }
+} // namespace
 
 namespace detail {
 
 template <typename DiagramConfig, typename GeneratorTag, typename DiagramModel>
-void generate_diagram_select_generator(const std::string &od,
-    const std::string &name, std::shared_ptr<clanguml::config::diagram> diagram,
-    const DiagramModel &model)
+std::string generate_diagram_output_impl(
+    clanguml::config::diagram &diagram, DiagramModel &model)
 {
     using diagram_generator =
         typename diagram_generator_t<DiagramConfig, GeneratorTag>::type;
 
     std::stringstream buffer;
-    buffer << diagram_generator(
-        dynamic_cast<DiagramConfig &>(*diagram), *model);
+    buffer << diagram_generator(dynamic_cast<DiagramConfig &>(diagram), model);
 
-    // Only open the file after the diagram has been generated successfully
-    // in order not to overwrite previous diagram in case of failure
-    auto path = std::filesystem::path{od} /
-        fmt::format("{}.{}", name, GeneratorTag::extension);
-    std::ofstream ofs;
-    ofs.open(path, std::ofstream::out | std::ofstream::trunc);
-    ofs << buffer.str();
+    return buffer.str();
+}
 
-    ofs.close();
+template <typename DiagramConfig, typename GeneratorTag, typename DiagramModel>
+bool generate_diagram_select_generator(const std::string &od,
+    const std::string &name, std::shared_ptr<clanguml::config::diagram> diagram,
+    const DiagramModel &model)
+{
+    const auto output =
+        generate_diagram_output_impl<DiagramConfig, GeneratorTag>(
+            *diagram, *model);
 
-    LOG_INFO("Written {} diagram to {}", name, path.string());
+    // Only open the file after the diagram has been generated successfully
+    // in order not to overwrite previous diagram in case of failure
+    return write_diagram_output(od, name, GeneratorTag::extension, output);
 }
 
 template <typename DiagramConfig>
-void generate_diagram_impl(const std::string &name,
+std::vector<generator_type_t> generate_diagram_impl(const std::string &name,
     std::shared_ptr<clanguml::config::diagram> diagram,
     const common::compilation_database &db,
     const std::vector<std::string> &translation_units,
-    const cli::runtime_config &runtime_config, std::function<void()> &&progress)
+    const cli::runtime_config &runtime_config, std::function<void()> &&progress,
+    diagram_profile *profile, std::set<std::string> *dependencies)
 {
     using diagram_config = DiagramConfig;
     using diagram_model = typename diagram_model_t<DiagramConfig>::type;
     using diagram_visitor = typename diagram_visitor_t<DiagramConfig>::type;
 
+    // JSON generators always include element comments
+    const auto parse_comments = diagram->comments_required() ||
+        util::contains(runtime_config.generators, generator_type_t::json);
+
     auto model = clanguml::common::generators::generate<diagram_model,
         diagram_config, diagram_visitor>(db, diagram->name,
         dynamic_cast<diagram_config &>(*diagram), translation_units,
-        runtime_config.verbose, std::move(progress));
+        runtime_config.verbose, std::move(progress), parse_comments, profile,
+        dependencies);
 
     if constexpr (std::is_same_v<DiagramConfig, config::sequence_diagram>) {
         if (runtime_config.print_from) {
@@ -136,7 +157,7 @@ void generate_diagram_impl(const std::string &name,
                 std::cout << from << '\n';
             }
 
-            return;
+            return {};
         }
         if (runtime_config.print_to) {
             auto to_values = model->list_to_values();
@@ -145,39 +166,125 @@ void generate_diagram_impl(const std::string &name,
                 std::cout << "|" << to << "|" << '\n';
             }
 
-            return;
+            return {};
         }
     }
 
-    for (const auto generator_type : runtime_config.generators) {
-        if (generator_type == generator_type_t::plantuml) {
-            generate_diagram_select_generator<diagram_config,
-                plantuml_generator_tag>(
-                runtime_config.output_directory, name, diagram, model);
-        }
-        else if (generator_type == generator_type_t::json) {
-            generate_diagram_select_generator<diagram_config,
-                json_generator_tag>(
-                runtime_config.output_directory, name, diagram, model);
+    // The model is read-only at this point, so each output format can be
+    // generated in parallel. These tasks are not scheduled on the diagram
+    // thread pool, as its workers may all be blocked waiting for them.
+    std::vector<std::future<bool>> generator_futures;
+
+    // Each generator records its time in its own preallocated slot
+    if (profile != nullptr) {
+        for (const auto generator_type : runtime_config.generators)
+            profile->generators_ms.emplace_back(generator_type, 0.0);
+    }
+
+    for (auto i = 0U; i < runtime_config.generators.size(); i++) {
+        const auto generator_type = runtime_config.generators[i];
+        generator_futures.emplace_back(std::async(std::launch::async,
+            [generator_type, i, profile, &name, &diagram, &model,
+                &runtime_config]() {
+                const auto start = profiler::clock::now();
+                util::trace_scope trace{"generator",
+                    fmt::format("{} {}", to_string(generator_type), name)};
+
+                bool written{false};
+                if (generator_type == generator_type_t::plantuml) {
+                    written = generate_diagram_select_generator<diagram_config,
+                        plantuml_generator_tag>(
+                        runtime_config.output_directory, name, diagram, model);
+                }
+                else if (generator_type == generator_type_t::json) {
+                    written = generate_diagram_select_generator<diagram_config,
+                        json_generator_tag>(
+                        runtime_config.output_directory, name, diagram, model);
+                }
+                else if (generator_type == generator_type_t::mermaid) {
+                    written = generate_diagram_select_generator<diagram_config,
+                        mermaid_generator_tag>(
+                        runtime_config.output_directory, name, diagram, model);
+                }
+
+                if (profile != nullptr)
+                    profile->generators_ms[i].second =
+                        profiler::elapsed_ms(start);
+
+                return written;
+            }));
+    }
+
+    // Wait for all generators before reporting the first error, as they all
+    // reference the model
+    std::vector<generator_type_t> written_outputs;
+    std::exception_ptr generator_error;
+    for (auto i = 0U; i < generator_futures.size(); i++) {
+        try {
+            if (generator_futures[i].get())
+                written_outputs.push_back(runtime_config.generators[i]);
         }
-        else if (generator_type == generator_type_t::mermaid) {
-            generate_diagram_select_generator<diagram_config,
-                mermaid_generator_tag>(
-                runtime_config.output_directory, name, diagram, model);
+        catch (...) {
+            if (!generator_error)
+                generator_error = std::current_exception();
         }
+    }
 
-        if (runtime_config.render_diagrams) {
-            render_diagram(generator_type, diagram);
-        }
+    if (generator_error)
+        std::rethrow_exception(generator_error);
+
+    return written_outputs;
+}
+
+template <typename DiagramConfig>
+std::unique_ptr<model::diagram> generate_diagram_model_impl(
+    std::shared_ptr<clanguml::config::diagram> diagram,
+    const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    std::set<std::string> *dependencies, std::function<void()> progress,
+    bool partial)
+{
+    using diagram_model = typename diagram_model_t<DiagramConfig>::type;
+    using diagram_visitor = typename diagram_visitor_t<DiagramConfig>::type;
+
+    // The model can be later generated in any format, including JSON, so
+    // element comments are always parsed
+    return clanguml::common::generators::generate<diagram_model,
+        DiagramConfig, diagram_visitor>(db, diagram->name,
+        dynamic_cast<DiagramConfig &>(*diagram), translation_units, false,
+        std::move(progress), true, nullptr, dependencies, partial);
+}
+
+template <typename DiagramConfig>
+std::string generate_diagram_output_select_generator(
+    generator_type_t generator_type, clanguml::config::diagram &diagram,
+    model::diagram &model)
+{
+    using diagram_model = typename diagram_model_t<DiagramConfig>::type;
+
+    auto &diagram_model_ref = dynamic_cast<diagram_model &>(model);
+
+    if (generator_type == generator_type_t::json) {
+        return generate_diagram_output_impl<DiagramConfig,
+            json_generator_tag>(diagram, diagram_model_ref);
+    }
+
+    if (generator_type == generator_type_t::mermaid) {
+        return generate_diagram_output_impl<DiagramConfig,
+            mermaid_generator_tag>(diagram, diagram_model_ref);
     }
+
+    return generate_diagram_output_impl<DiagramConfig, plantuml_generator_tag>(
+        diagram, diagram_model_ref);
 }
 } // namespace detail
 
-void generate_diagram(const std::string &name,
+std::vector<generator_type_t> generate_diagram(const std::string &name,
     std::shared_ptr<clanguml::config::diagram> diagram,
     const common::compilation_database &db,
     const std::vector<std::string> &translation_units,
-    const cli::runtime_config &runtime_config, std::function<void()> &&progress)
+    const cli::runtime_config &runtime_config, std::function<void()> &&progress,
+    diagram_profile *profile, std::set<std::string> *dependencies)
 {
     using clanguml::common::generator_type_t;
     using clanguml::common::model::diagram_t;
@@ -188,47 +295,233 @@ void generate_diagram(const std::string &name,
     using clanguml::config::sequence_diagram;
 
     if (diagram->type() == diagram_t::kClass) {
-        detail::generate_diagram_impl<class_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+        return detail::generate_diagram_impl<class_diagram>(name, diagram, db,
+            translation_units, runtime_config, std::move(progress), profile,
+            dependencies);
     }
     else if (diagram->type() == diagram_t::kSequence) {
-        detail::generate_diagram_impl<sequence_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+        return detail::generate_diagram_impl<sequence_diagram>(name, diagram,
+            db, translation_units, runtime_config, std::move(progress),
+            profile, dependencies);
     }
     else if (diagram->type() == diagram_t::kPackage) {
-        detail::generate_diagram_impl<package_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+        return detail::generate_diagram_impl<package_diagram>(name, diagram, db,
+            translation_units, runtime_config, std::move(progress), profile,
+            dependencies);
     }
     else if (diagram->type() == diagram_t::kInclude) {
-        detail::generate_diagram_impl<include_diagram>(name, diagram, db,
-            translation_units, runtime_config, std::move(progress));
+        return detail::generate_diagram_impl<include_diagram>(name, diagram, db,
+            translation_units, runtime_config, std::move(progress), profile,
+            dependencies);
     }
+
+    return {};
 }
 
-void generate_diagrams(const std::vector<std::string> &diagram_names,
+namespace {
+std::filesystem::path output_path(const cli::runtime_config &runtime_config,
+    const std::string &name, generator_type_t generator_type)
+{
+    return std::filesystem::path{runtime_config.output_directory} /
+        fmt::format("{}.{}", name, generator_extension(generator_type));
+}
+
+/**
+ * Check whether the image rendered from a diagram exists and is not older
+ * than the diagram file. Images whose path cannot be determined from the
+ * render command are assumed to be up to date.
+ */
+bool is_rendered(const cli::runtime_config &runtime_config,
+    const config::diagram &diagram, generator_type_t generator_type)
+{
+    const auto image = render_queue::rendered_path(generator_type, diagram);
+    if (!image)
+        return true;
+
+    std::error_code ec;
+    const auto image_time = std::filesystem::last_write_time(*image, ec);
+    if (ec)
+        return false;
+
+    const auto diagram_time = std::filesystem::last_write_time(
+        output_path(runtime_config, diagram.name, generator_type), ec);
+
+    return ec || image_time >= diagram_time;
+}
+
+/**
+ * Check whether a diagram has to be rendered, i.e. its output was written
+ * or the image rendered from its unchanged output is missing or stale
+ */
+bool needs_render(const cli::runtime_config &runtime_config,
+    const config::diagram &diagram,
+    const std::vector<generator_type_t> &written_outputs,
+    generator_type_t generator_type)
+{
+    return util::contains(written_outputs, generator_type) ||
+        !is_rendered(runtime_config, diagram, generator_type);
+}
+
+bool outputs_exist(
+    const cli::runtime_config &runtime_config, const config::diagram &diagram)
+{
+    return std::all_of(runtime_config.generators.begin(),
+        runtime_config.generators.end(), [&](const auto generator_type) {
+            return std::filesystem::exists(output_path(
+                       runtime_config, diagram.name, generator_type)) &&
+                (!runtime_config.render_diagrams ||
+                    is_rendered(runtime_config, diagram, generator_type));
+        });
+}
+} // namespace
+
+std::unique_ptr<model::diagram> generate_diagram_model(
+    std::shared_ptr<clanguml::config::diagram> diagram,
+    const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    std::set<std::string> *dependencies, std::function<void()> progress,
+    bool partial)
+{
+    using clanguml::common::model::diagram_t;
+
+    switch (diagram->type()) {
+    case diagram_t::kClass:
+        return detail::generate_diagram_model_impl<config::class_diagram>(
+            diagram, db, translation_units, dependencies, std::move(progress),
+            partial);
+    case diagram_t::kSequence:
+        return detail::generate_diagram_model_impl<config::sequence_diagram>(
+            diagram, db, translation_units, dependencies, std::move(progress),
+            partial);
+    case diagram_t::kPackage:
+        return detail::generate_diagram_model_impl<config::package_diagram>(
+            diagram, db, translation_units, dependencies, std::move(progress),
+            partial);
+    case diagram_t::kInclude:
+        return detail::generate_diagram_model_impl<config::include_diagram>(
+            diagram, db, translation_units, dependencies, std::move(progress),
+            partial);
+    default:
+        throw std::runtime_error(
+            fmt::format("Unsupported diagram type of {}", diagram->name));
+    }
+}
+
+std::string generate_diagram_output(generator_type_t generator_type,
+    clanguml::config::diagram &diagram, model::diagram &model)
+{
+    using clanguml::common::model::diagram_t;
+
+    switch (diagram.type()) {
+    case diagram_t::kClass:
+        return detail::generate_diagram_output_select_generator<
+            config::class_diagram>(generator_type, diagram, model);
+    case diagram_t::kSequence:
+        return detail::generate_diagram_output_select_generator<
+            config::sequence_diagram>(generator_type, diagram, model);
+    case diagram_t::kPackage:
+        return detail::generate_diagram_output_select_generator<
+            config::package_diagram>(generator_type, diagram, model);
+    case diagram_t::kInclude:
+        return detail::generate_diagram_output_select_generator<
+            config::include_diagram>(generator_type, diagram, model);
+    default:
+        throw std::runtime_error(
+            fmt::format("Unsupported diagram type of {}", diagram.name));
+    }
+}
+
+unsigned generate_diagrams(const std::vector<std::string> &diagram_names,
     config::config &config, const common::compilation_database_ptr &db,
     const cli::runtime_config &runtime_config,
     const std::map<std::string, std::vector<std::string>>
-        &translation_units_map)
+        &translation_units_map,
+    std::map<std::string, std::set<std::string>> *dependencies)
 {
+    const auto start = profiler::clock::now();
+
+    if (runtime_config.trace_file)
+        util::tracer::instance().start(*runtime_config.trace_file);
+
     util::thread_pool_executor generator_executor{runtime_config.thread_count};
     std::vector<std::future<void>> futs;
 
+    std::unique_ptr<profiler> profiles;
+    if (runtime_config.profile)
+        profiles = std::make_unique<profiler>();
+
+    std::unique_ptr<memory_budget> budget;
+    if (runtime_config.memory_limit > 0)
+        budget = std::make_unique<memory_budget>(runtime_config.memory_limit);
+
+    std::unique_ptr<manifest> inputs_manifest;
+    // Partial models of shards are always written, as they are not tracked
+    // in the manifest
+    if (runtime_config.incremental && runtime_config.shard_count == 0 &&
+        !runtime_config.print_from && !runtime_config.print_to)
+        inputs_manifest = std::make_unique<manifest>(
+            std::filesystem::path{runtime_config.output_directory} /
+            manifest::kFileName);
+
+    // The manifest needs the files read by each diagram, even if the caller
+    // is not interested in them
+    std::map<std::string, std::set<std::string>> manifest_dependencies;
+    if (inputs_manifest && dependencies == nullptr)
+        dependencies = &manifest_dependencies;
+
     std::unique_ptr<progress_indicator> indicator;
 
+    std::unique_ptr<render_queue> renders;
+    if (runtime_config.render_diagrams)
+        renders = std::make_unique<render_queue>(
+            runtime_config.render_batch_size, runtime_config.render_jobs);
+
     if (runtime_config.progress) {
         std::cout << termcolor::white
                   << "Processing translation units and generating diagrams:\n";
         indicator = std::make_unique<progress_indicator>();
     }
 
+    std::atomic<std::size_t> skipped_count{0};
+    std::atomic<std::size_t> unchanged_count{0};
+
+    const std::filesystem::path compilation_database_dir{
+        config.compilation_database_dir()};
+
     for (const auto &[name, diagram] : config.diagrams) {
         // If there are any specific diagram names provided on the command
         // line, and this diagram is not in that list - skip it
         if (!diagram_names.empty() && !util::contains(diagram_names, name))
             continue;
 
-        const auto &valid_translation_units = translation_units_map.at(name);
+        const auto is_shard = runtime_config.shard_count > 0;
+
+        const auto &all_translation_units = translation_units_map.at(name);
+
+        const auto valid_translation_units = is_shard
+            ? shard_translation_units(all_translation_units,
+                  compilation_database_dir, runtime_config.shard_index,
+                  runtime_config.shard_count)
+            : all_translation_units;
+
+        // The merge step expects a partial model from each shard, even if
+        // all translation units of the diagram were assigned to other shards
+        if (is_shard && valid_translation_units.empty() &&
+            !all_translation_units.empty()) {
+            try {
+                export_partial_model(
+                    shard_path(runtime_config.output_directory, name,
+                        runtime_config.shard_index, runtime_config.shard_count),
+                    *diagram, nullptr, all_translation_units,
+                    compilation_database_dir, runtime_config.shard_index,
+                    runtime_config.shard_count);
+            }
+            catch (const std::exception &e) {
+                LOG_ERROR("ERROR: Failed to generate diagram {}: {}", name,
+                    e.what());
+            }
+            continue;
+        }
 
         if (valid_translation_units.empty()) {
             if (indicator) {
@@ -249,25 +542,133 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
         const auto matching_commands_count =
             db->count_matching_commands(valid_translation_units);
 
+        diagram_profile *profile{nullptr};
+        if (profiles)
+            profile = &profiles->add_diagram(name, diagram->type());
+
+        // Each diagram task records its dependencies in its own entry,
+        // created before the tasks are started
+        std::set<std::string> *diagram_dependencies{nullptr};
+        if (dependencies != nullptr) {
+            diagram_dependencies = &(*dependencies)[name];
+            diagram_dependencies->clear();
+        }
+
         auto generator = [&name = name, &diagram = diagram, &indicator,
-                             db = std::ref(*db), matching_commands_count,
+                             &renders, db = std::ref(*db),
+                             matching_commands_count,
                              translation_units = valid_translation_units,
-                             runtime_config]() mutable {
+                             &all_translation_units, &compilation_database_dir,
+                             runtime_config, profile, diagram_dependencies,
+                             budget = budget.get(),
+                             inputs_manifest = inputs_manifest.get(),
+                             &unchanged_count, &skipped_count]() mutable {
+            util::trace_scope trace{"diagram", name};
+
             try {
+                const auto diagram_start = profiler::clock::now();
+                const auto inputs_start =
+                    std::filesystem::file_time_type::clock::now();
+
+                // Inputs are checked by the diagram task, so that checking
+                // many diagrams runs in parallel
+                std::string fingerprint;
+                if (inputs_manifest != nullptr) {
+                    fingerprint = diagram_fingerprint(
+                        *diagram, db, translation_units, runtime_config);
+
+                    if (inputs_manifest->is_up_to_date(name, fingerprint) &&
+                        outputs_exist(runtime_config, *diagram)) {
+                        LOG_INFO("Skipping diagram {} - its inputs have not "
+                                 "changed",
+                            name);
+
+                        if (indicator) {
+                            indicator->add_progress_bar(name, 0,
+                                diagram_type_to_color(diagram->type()));
+                            indicator->complete(name);
+                        }
+
+                        if (diagram_dependencies != nullptr)
+                            *diagram_dependencies =
+                                inputs_manifest->files(name);
+
+                        if (profile != nullptr)
+                            profile->total_ms =
+                                profiler::elapsed_ms(diagram_start);
+
+                        skipped_count++;
+                        return;
+                    }
+                }
+
+                memory_budget_guard budget_guard{budget};
+
                 if (indicator)
                     indicator->add_progress_bar(name, matching_commands_count,
                         diagram_type_to_color(diagram->type()));
 
-                generate_diagram(name, diagram, db, translation_units,
-                    runtime_config, [&indicator, &name]() {
-                        if (indicator)
-                            indicator->increment(name);
-                    });
+                auto progress = [&indicator, &name, budget]() {
+                    // Called before each translation unit, when the
+                    // previous translation unit AST is already released
+                    if (budget != nullptr)
+                        budget->checkpoint();
+
+                    if (indicator)
+                        indicator->increment(name);
+                };
+
+                std::vector<generator_type_t> written_outputs;
+                if (runtime_config.shard_count > 0) {
+                    // Partial models are finalized after they are merged
+                    const auto partial_model =
+                        generate_diagram_model(diagram, db, translation_units,
+                            diagram_dependencies, std::move(progress), true);
+
+                    export_partial_model(
+                        shard_path(runtime_config.output_directory, name,
+                            runtime_config.shard_index,
+                            runtime_config.shard_count),
+                        *diagram, partial_model.get(), all_translation_units,
+                        compilation_database_dir, runtime_config.shard_index,
+                        runtime_config.shard_count);
+                }
+                else {
+                    written_outputs = generate_diagram(name, diagram, db,
+                        translation_units, runtime_config, std::move(progress),
+                        profile, diagram_dependencies);
+
+                    if (!runtime_config.print_from && !runtime_config.print_to)
+                        unchanged_count += runtime_config.generators.size() -
+                            written_outputs.size();
+                }
+
+                if (profile != nullptr)
+                    profile->total_ms = profiler::elapsed_ms(diagram_start);
+
+                // Diagrams are only rendered again if their output changed,
+                // or if the image from the previous run is missing or stale
+                if (renders && runtime_config.shard_count == 0 &&
+                    !runtime_config.print_from && !runtime_config.print_to) {
+                    for (const auto generator_type :
+                        runtime_config.generators) {
+                        if (needs_render(runtime_config, *diagram,
+                                written_outputs, generator_type))
+                            renders->add(generator_type, *diagram);
+                    }
+                }
+
+                if (inputs_manifest != nullptr)
+                    inputs_manifest->update(name, std::move(fingerprint),
+                        *diagram_dependencies, inputs_start);
 
                 if (indicator)
                     indicator->complete(name);
             }
             catch (const std::exception &e) {
+                if (inputs_manifest != nullptr)
+                    inputs_manifest->remove(name);
+
                 if (indicator)
                     indicator->fail(name);
 
@@ -283,11 +684,111 @@ void generate_diagrams(const std::vector<std::string> &diagram_names,
         fut.get();
     }
 
+    if (unchanged_count > 0)
+        LOG_INFO("Skipped writing {} unchanged diagram files",
+            unchanged_count.load());
+
+    if (inputs_manifest) {
+        inputs_manifest->write();
+
+        if (skipped_count > 0)
+            LOG_INFO("Skipped {} diagrams with unchanged inputs",
+                skipped_count.load());
+    }
+
+    unsigned failed_renders{0};
+    if (renders) {
+        const auto wait_start = profiler::clock::now();
+
+        failed_renders = renders->wait();
+        if (failed_renders > 0)
+            LOG_ERROR("Failed to render {} diagrams", failed_renders);
+
+        if (profiles)
+            profiles->set_render_ms(
+                std::chrono::duration<double, std::milli>(
+                    renders->commands_time())
+                    .count(),
+                profiler::elapsed_ms(wait_start));
+    }
+
     if (runtime_config.progress) {
         indicator->stop();
         std::cout << termcolor::white << "Done\n";
         std::cout << termcolor::reset;
     }
+
+    util::tracer::instance().stop();
+
+    if (budget) {
+        LOG_INFO("Peak memory usage: {} MB (limit {} MB)",
+            profiler::peak_rss_kb() / 1024, budget->limit_kb() / 1024);
+    }
+
+    if (profiles) {
+        profiles->set_compile_commands_adjustment_ms(
+            std::chrono::duration<double, std::milli>(db->adjustment_time())
+                .count());
+        profiles->set_total_ms(profiler::elapsed_ms(start));
+
+        profiles->print(std::cout);
+        profiles->write(std::filesystem::path{runtime_config.output_directory} /
+            "clang-uml-profile.json");
+    }
+
+    return failed_renders;
+}
+
+unsigned merge_diagrams(const std::vector<std::string> &diagram_names,
+    config::config &config, const cli::runtime_config &runtime_config)
+{
+    unsigned failed_count{0};
+
+    std::unique_ptr<render_queue> renders;
+    if (runtime_config.render_diagrams)
+        renders = std::make_unique<render_queue>(
+            runtime_config.render_batch_size, runtime_config.render_jobs);
+
+    for (const auto &[name, diagram] : config.diagrams) {
+        // If there are any specific diagram names provided on the command
+        // line, and this diagram is not in that list - skip it
+        if (!diagram_names.empty() && !util::contains(diagram_names, name))
+            continue;
+
+        try {
+            const auto model =
+                merge_partial_models(*diagram, runtime_config.output_directory);
+
+            for (const auto generator_type : runtime_config.generators) {
+                const auto written =
+                    write_diagram_output(runtime_config.output_directory, name,
+                        generator_extension(generator_type),
+                        generate_diagram_output(
+                            generator_type, *diagram, *model));
+
+                // Diagrams are only rendered again if their output changed,
+                // or if the image from the previous run is missing or stale
+                if (renders &&
+                    (written ||
+                        !is_rendered(runtime_config, *diagram, generator_type)))
+                    renders->add(generator_type, *diagram);
+            }
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR("ERROR: Failed to merge diagram {}: {}", name, e.what());
+            failed_count++;
+        }
+    }
+
+    if (renders) {
+        const auto failed_renders = renders->wait();
+        if (failed_renders > 0)
+            LOG_ERROR("Failed to render {} diagrams", failed_renders);
+
+        failed_count += failed_renders;
+    }
+
+    return failed_count;
 }
 
 indicators::Color diagram_type_to_color(model::diagram_t diagram_type)
@@ -31,21 +31,26 @@
 #include "package_diagram/generators/json/package_diagram_generator.h"
 #include "package_diagram/generators/mermaid/package_diagram_generator.h"
 #include "package_diagram/generators/plantuml/package_diagram_generator.h"
+#include "profiler.h"
 #include "sequence_diagram/generators/json/sequence_diagram_generator.h"
 #include "sequence_diagram/generators/mermaid/sequence_diagram_generator.h"
 #include "sequence_diagram/generators/plantuml/sequence_diagram_generator.h"
+#include "util/trace.h"
 #include "util/util.h"
 #include "version.h"
 
 #include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/Utils.h>
 #include <clang/Tooling/Tooling.h>
 
+#include <algorithm>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <future>
 #include <iostream>
 #include <map>
+#include <set>
 #include <string>
 #include <util/thread_pool_executor.h>
 #include <vector>
@@ -224,10 +229,14 @@ template <typename DiagramModel, typename DiagramConfig,
 class diagram_ast_consumer : public clang::ASTConsumer {
     TranslationUnitVisitor visitor_;
 
+    translation_unit_profile *profile_;
+
 public:
     explicit diagram_ast_consumer(clang::CompilerInstance &ci,
-        DiagramModel &diagram, const DiagramConfig &config)
+        DiagramModel &diagram, const DiagramConfig &config,
+        translation_unit_profile *profile = nullptr)
         : visitor_{ci.getSourceManager(), diagram, config}
+        , profile_{profile}
     {
     }
 
@@ -235,8 +244,29 @@ public:
 
     void HandleTranslationUnit(clang::ASTContext &ast_context) override
     {
-        visitor_.TraverseDecl(ast_context.getTranslationUnitDecl());
-        visitor_.finalize();
+        // Memoize type names and ids until the translation unit AST is
+        // released
+        common::type_name_cache type_names;
+
+        auto start = profiler::clock::now();
+
+        {
+            util::trace_scope trace{"visitor", "traverse"};
+            visitor_.TraverseDecl(ast_context.getTranslationUnitDecl());
+        }
+
+        if (profile_ != nullptr) {
+            profile_->traverse_ms = profiler::elapsed_ms(start);
+            start = profiler::clock::now();
+        }
+
+        {
+            util::trace_scope trace{"visitor", "finalize"};
+            visitor_.finalize();
+        }
+
+        if (profile_ != nullptr)
+            profile_->finalize_ms = profiler::elapsed_ms(start);
     }
 };
 
@@ -256,10 +286,15 @@ template <typename DiagramModel, typename DiagramConfig,
 class diagram_fronted_action : public clang::ASTFrontendAction {
 public:
     explicit diagram_fronted_action(DiagramModel &diagram,
-        const DiagramConfig &config, std::function<void()> progress)
+        const DiagramConfig &config, std::function<void()> progress,
+        bool parse_comments, diagram_profile *profile,
+        std::set<std::string> *dependencies)
         : diagram_{diagram}
         , config_{config}
         , progress_{std::move(progress)}
+        , parse_comments_{parse_comments}
+        , profile_{profile}
+        , dependencies_{dependencies}
     {
     }
 
@@ -268,11 +303,13 @@ public:
     {
         auto ast_consumer = std::make_unique<
             diagram_ast_consumer<DiagramModel, DiagramConfig, DiagramVisitor>>(
-            CI, diagram_, config_);
+            CI, diagram_, config_,
+            profile_ != nullptr ? &translation_unit_profile_ : nullptr);
 
         if constexpr (!std::is_same_v<DiagramModel,
                           clanguml::include_diagram::model::diagram>) {
             ast_consumer->visitor().set_tu_path(getCurrentFile().str());
+            ast_consumer->visitor().set_parse_comments(parse_comments_);
         }
 
         return ast_consumer;
@@ -284,10 +321,18 @@ protected:
         LOG_DBG("Visiting source file: {}", getCurrentFile().str());
 
         // Update progress indicators, if enabled, on each translation
-        // unit
+        // unit. This can block while waiting for the memory budget, so it
+        // is not included in translation unit timings.
         if (progress_)
             progress_();
 
+        translation_unit_start_ = profiler::clock::now();
+
+        if (profile_ != nullptr) {
+            translation_unit_profile_ = {};
+            translation_unit_profile_.path = getCurrentFile().str();
+        }
+
         if constexpr (std::is_same_v<DiagramModel,
                           clanguml::include_diagram::model::diagram>) {
             auto find_includes_callback =
@@ -299,13 +344,70 @@ protected:
             pp.addPPCallbacks(std::move(find_includes_callback));
         }
 
+        if (dependencies_ != nullptr) {
+            dependency_collector_ =
+                std::make_unique<clang::DependencyCollector>();
+            dependency_collector_->attachToPreprocessor(ci.getPreprocessor());
+        }
+
         return true;
     }
 
+    void EndSourceFileAction() override
+    {
+        auto &tracer = util::tracer::instance();
+        if (tracer.enabled())
+            tracer.add_event("clang", getCurrentFile().str(),
+                translation_unit_start_, util::tracer::clock::now());
+
+        if (dependency_collector_)
+            record_dependencies();
+
+        if (profile_ == nullptr)
+            return;
+
+        auto &tu = translation_unit_profile_;
+        tu.total_ms = profiler::elapsed_ms(translation_unit_start_);
+        tu.parse_ms =
+            std::max(0.0, tu.total_ms - tu.traverse_ms - tu.finalize_ms);
+
+        profile_->translation_units.emplace_back(std::move(tu));
+    }
+
 private:
+    /**
+     * @brief Add absolute paths of the translation unit and all non-system
+     *        headers it includes to the diagram dependencies
+     */
+    void record_dependencies()
+    {
+        auto &vfs =
+            getCompilerInstance().getFileManager().getVirtualFileSystem();
+
+        auto add_dependency = [this, &vfs](llvm::StringRef file) {
+            llvm::SmallString<256> path{file};
+            vfs.makeAbsolute(path);
+            llvm::sys::path::remove_dots(path, true);
+            dependencies_->emplace(path.str().str());
+        };
+
+        add_dependency(getCurrentFile());
+
+        for (const auto &file : dependency_collector_->getDependencies())
+            add_dependency(file);
+
+        dependency_collector_.reset();
+    }
+
     DiagramModel &diagram_;
     const DiagramConfig &config_;
     std::function<void()> progress_;
+    bool parse_comments_;
+    diagram_profile *profile_;
+    std::set<std::string> *dependencies_;
+    std::unique_ptr<clang::DependencyCollector> dependency_collector_;
+    translation_unit_profile translation_unit_profile_;
+    profiler::clock::time_point translation_unit_start_;
 };
 
 /**
@@ -325,23 +427,32 @@ class diagram_action_visitor_factory
     : public clang::tooling::FrontendActionFactory {
 public:
     explicit diagram_action_visitor_factory(DiagramModel &diagram,
-        const DiagramConfig &config, std::function<void()> progress)
+        const DiagramConfig &config, std::function<void()> progress,
+        bool parse_comments, diagram_profile *profile,
+        std::set<std::string> *dependencies)
         : diagram_{diagram}
         , config_{config}
         , progress_{std::move(progress)}
+        , parse_comments_{parse_comments}
+        , profile_{profile}
+        , dependencies_{dependencies}
     {
     }
 
     std::unique_ptr<clang::FrontendAction> create() override
     {
         return std::make_unique<diagram_fronted_action<DiagramModel,
-            DiagramConfig, DiagramVisitor>>(diagram_, config_, progress_);
+            DiagramConfig, DiagramVisitor>>(diagram_, config_, progress_,
+            parse_comments_, profile_, dependencies_);
     }
 
 private:
     DiagramModel &diagram_;
     const DiagramConfig &config_;
     std::function<void()> progress_;
+    bool parse_comments_;
+    diagram_profile *profile_;
+    std::set<std::string> *dependencies_;
 };
 
 /**
@@ -356,13 +467,22 @@ private:
  * @tparam DiagramModel Type of diagram_model
  * @tparam DiagramConfig Type of diagram_config
  * @tparam TranslationUnitVisitor Type of translation_unit_visitor
+ * @param parse_comments Whether element comments are used by any generator
+ * @param profile Diagram profile to record timings in (optional)
+ * @param dependencies Set to add the files read by the translation units to
+ *                     (optional)
+ * @param partial Whether the model is built by a shard, in which case it is
+ *                not finalized, as it will be merged with models of other
+ *                shards
  */
 template <typename DiagramModel, typename DiagramConfig,
     typename DiagramVisitor>
 std::unique_ptr<DiagramModel> generate(const common::compilation_database &db,
     const std::string &name, DiagramConfig &config,
     const std::vector<std::string> &translation_units, bool /*verbose*/ = false,
-    std::function<void()> progress = {})
+    std::function<void()> progress = {}, bool parse_comments = true,
+    diagram_profile *profile = nullptr,
+    std::set<std::string> *dependencies = nullptr, bool partial = false)
 {
     LOG_INFO("Generating diagram {}", name);
 
@@ -377,18 +497,38 @@ std::unique_ptr<DiagramModel> generate(const common::compilation_database &db,
     clang::tooling::ClangTool clang_tool(db, translation_units);
     auto action_factory =
         std::make_unique<diagram_action_visitor_factory<DiagramModel,
-            DiagramConfig, DiagramVisitor>>(
-            *diagram, config, std::move(progress));
+            DiagramConfig, DiagramVisitor>>(*diagram, config,
+            std::move(progress), parse_comments, profile, dependencies);
 
-    auto res = clang_tool.run(action_factory.get());
+    auto start = profiler::clock::now();
+
+    int res{};
+    {
+        util::trace_scope trace{"clang", fmt::format("ClangTool {}", name)};
+        res = clang_tool.run(action_factory.get());
+    }
 
     if (res != 0) {
         throw std::runtime_error("Diagram " + name + " generation failed");
     }
 
+    if (profile != nullptr) {
+        profile->clang_ms = profiler::elapsed_ms(start);
+        start = profiler::clock::now();
+    }
+
+    if (partial)
+        return diagram;
+
     diagram->set_complete(true);
 
-    diagram->finalize();
+    {
+        util::trace_scope trace{"diagram", fmt::format("finalize {}", name)};
+        diagram->finalize();
+    }
+
+    if (profile != nullptr)
+        profile->finalize_ms = profiler::elapsed_ms(start);
 
     return diagram;
 }
@@ -403,13 +543,53 @@ std::unique_ptr<DiagramModel> generate(const common::compilation_database &db,
  * @param generators List of generator types to be used for the diagram
  * @param verbose Log level
  * @param progress Function to report translation unit progress
+ * @param profile Diagram profile to record timings in (optional)
+ * @param dependencies Set to add the files the diagram depends on to
+ *                     (optional)
+ * @return Generator types, whose output files were written (i.e. their
+ *         content has changed)
  */
-void generate_diagram(const std::string &name,
+std::vector<generator_type_t> generate_diagram(const std::string &name,
     std::shared_ptr<clanguml::config::diagram> diagram,
     const common::compilation_database &db,
     const std::vector<std::string> &translation_units,
-    const cli::runtime_config &runtime_config,
-    std::function<void()> &&progress);
+    const cli::runtime_config &runtime_config, std::function<void()> &&progress,
+    diagram_profile *profile = nullptr,
+    std::set<std::string> *dependencies = nullptr);
+
+/**
+ * @brief Build the model of a single diagram without generating any output
+ *
+ * Element comments are always parsed, so that the model can be generated
+ * in any format using generate_diagram_output().
+ *
+ * @param diagram Effective diagram configuration
+ * @param db Reference to compilation database
+ * @param translation_units List of translation units for the diagram
+ * @param dependencies Set to add the files the diagram depends on to
+ *                     (optional)
+ * @param progress Function to report translation unit progress (optional)
+ * @param partial Whether the model is built by a shard and should not be
+ *                finalized
+ * @return Diagram model
+ */
+std::unique_ptr<model::diagram> generate_diagram_model(
+    std::shared_ptr<clanguml::config::diagram> diagram,
+    const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    std::set<std::string> *dependencies = nullptr,
+    std::function<void()> progress = {}, bool partial = false);
+
+/**
+ * @brief Generate diagram in a specific format from its model
+ *
+ * @param generator_type Type of the generator
+ * @param diagram Effective diagram configuration
+ * @param model Diagram model created by generate_diagram_model()
+ * @return Generated diagram
+ */
+std::string generate_diagram_output(generator_type_t generator_type,
+    clanguml::config::diagram &diagram, model::diagram &model);
 
 /**
  * @brief Generate diagrams
@@ -423,13 +603,29 @@ void generate_diagram(const std::string &name,
  * @param progress Whether progress indicators should be displayed
  * @param generators List of generator types to use for each diagram
  * @param translation_units_map Map of translation units for each file
+ * @param dependencies Map to store the files each generated diagram depends
+ *                     on in (optional)
+ * @return Number of diagrams which failed to render
  */
-void generate_diagrams(const std::vector<std::string> &diagram_names,
+unsigned generate_diagrams(const std::vector<std::string> &diagram_names,
     clanguml::config::config &config,
     const common::compilation_database_ptr &db,
     const cli::runtime_config &runtime_config,
     const std::map<std::string, std::vector<std::string>>
-        &translation_units_map);
+        &translation_units_map,
+    std::map<std::string, std::set<std::string>> *dependencies = nullptr);
+
+/**
+ * @brief Generate diagrams from partial models written by `--shard` runs
+ *
+ * @param diagram_names List of diagram names to generate
+ * @param config Reference to config instance
+ * @param runtime_config Runtime configuration
+ * @return Number of diagrams which failed to merge or render
+ */
+unsigned merge_diagrams(const std::vector<std::string> &diagram_names,
+    clanguml::config::config &config,
+    const cli::runtime_config &runtime_config);
 
 /**
  * @brief Return indicators progress bar color for diagram type
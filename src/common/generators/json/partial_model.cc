@@ -0,0 +1,587 @@
+/**
+ * @file src/common/generators/json/partial_model.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_model.h"
+
+#include "decorators/decorators.h"
+
+#include <map>
+
+namespace clanguml::common::generators::json {
+
+using common::model::access_t;
+using common::model::context;
+using common::model::path_type;
+using common::model::relationship_t;
+using common::model::rpqualifier;
+using common::model::template_parameter;
+using common::model::template_parameter_kind_t;
+
+namespace {
+std::string to_string(rpqualifier q)
+{
+    switch (q) {
+    case rpqualifier::kLValueReference:
+        return "&";
+    case rpqualifier::kRValueReference:
+        return "&&";
+    case rpqualifier::kPointer:
+        return "*";
+    default:
+        return "";
+    }
+}
+
+rpqualifier rpqualifier_from_string(const std::string &name)
+{
+    for (const auto q : {rpqualifier::kLValueReference,
+             rpqualifier::kRValueReference, rpqualifier::kPointer,
+             rpqualifier::kNone}) {
+        if (to_string(q) == name)
+            return q;
+    }
+
+    throw std::runtime_error(
+        fmt::format("Invalid value '{}' in partial model", name));
+}
+
+std::string strip_variadic(std::string name)
+{
+    if (util::ends_with(name, std::string{"..."}))
+        name.resize(name.size() - 3);
+
+    return name;
+}
+
+template <typename T>
+std::optional<T> get_optional(const nlohmann::json &j, const std::string &key)
+{
+    if (!j.contains(key))
+        return {};
+
+    return j.at(key).get<T>();
+}
+} // namespace
+
+nlohmann::json export_id(eid_t id) { return std::to_string(id.value()); }
+
+eid_t import_id(const nlohmann::json &j)
+{
+    return eid_t{static_cast<eid_t::type>(std::stoull(j.get<std::string>()))};
+}
+
+model::access_t import_access(const nlohmann::json &j)
+{
+    return enum_from_string(j.get<std::string>(),
+        {access_t::kPublic, access_t::kProtected, access_t::kPrivate,
+            access_t::kNone});
+}
+
+model::relationship_t import_relationship_type(const nlohmann::json &j)
+{
+    return enum_from_string(j.get<std::string>(),
+        {relationship_t::kNone, relationship_t::kExtension,
+            relationship_t::kComposition, relationship_t::kAggregation,
+            relationship_t::kContainment, relationship_t::kOwnership,
+            relationship_t::kAssociation, relationship_t::kInstantiation,
+            relationship_t::kFriendship, relationship_t::kAlias,
+            relationship_t::kDependency, relationship_t::kConstraint});
+}
+
+nlohmann::json export_path(const model::path &p)
+{
+    return {{"type", to_string(p.type())}, {"elements", p.tokens()}};
+}
+
+model::path import_path(const nlohmann::json &j)
+{
+    const auto type = enum_from_string(j.at("type").get<std::string>(),
+        {path_type::kNamespace, path_type::kFilesystem, path_type::kModule});
+    const auto elements = j.at("elements").get<std::vector<std::string>>();
+
+    return model::path{elements.cbegin(), elements.cend(), type};
+}
+
+void export_source_location(
+    const model::source_location &sl, nlohmann::json &j)
+{
+    if (sl.file().empty())
+        return;
+
+    j["source_location"] = {{"file", sl.file()},
+        {"file_relative", sl.file_relative()},
+        {"translation_unit", sl.translation_unit()}, {"line", sl.line()},
+        {"column", sl.column()}};
+}
+
+void import_source_location(
+    const nlohmann::json &j, model::source_location &sl)
+{
+    if (!j.contains("source_location"))
+        return;
+
+    const auto &l = j.at("source_location");
+    sl.set_file(l.at("file").get<std::string>());
+    sl.set_file_relative(l.at("file_relative").get<std::string>());
+    sl.set_translation_unit(l.at("translation_unit").get<std::string>());
+    sl.set_line(l.at("line").get<unsigned int>());
+    sl.set_column(l.at("column").get<unsigned int>());
+}
+
+void export_decorated_element(
+    const model::decorated_element &e, nlohmann::json &j)
+{
+    if (const auto &comment = e.comment(); comment)
+        j["comment"] = comment.value();
+
+    if (!e.decorators().empty())
+        j["decorators"] = export_decorators(e);
+}
+
+void import_decorated_element(
+    const nlohmann::json &j, model::decorated_element &e)
+{
+    if (j.contains("comment"))
+        e.set_comment(j.at("comment"));
+
+    import_decorators(j, e);
+}
+
+nlohmann::json export_decorators(const model::decorated_element &e)
+{
+    auto result = nlohmann::json::array();
+
+    for (const auto &d : e.decorators()) {
+        nlohmann::json dj{{"diagrams", d->diagrams}};
+
+        if (const auto n = std::dynamic_pointer_cast<decorators::note>(d); n) {
+            dj["type"] = decorators::note::label;
+            dj["position"] = n->position;
+            dj["text"] = n->text;
+        }
+        else if (std::dynamic_pointer_cast<decorators::skip>(d)) {
+            dj["type"] = decorators::skip::label;
+        }
+        else if (std::dynamic_pointer_cast<decorators::skip_relationship>(d)) {
+            dj["type"] = decorators::skip_relationship::label;
+        }
+        else if (const auto s = std::dynamic_pointer_cast<decorators::style>(d);
+                 s) {
+            dj["type"] = decorators::style::label;
+            dj["spec"] = s->spec;
+        }
+        else if (const auto c = std::dynamic_pointer_cast<decorators::call>(d);
+                 c) {
+            dj["type"] = decorators::call::label;
+            dj["callee"] = c->callee;
+        }
+        else if (const auto r =
+                     std::dynamic_pointer_cast<decorators::relationship>(d);
+                 r) {
+            if (std::dynamic_pointer_cast<decorators::aggregation>(d))
+                dj["type"] = decorators::aggregation::label;
+            else if (std::dynamic_pointer_cast<decorators::composition>(d))
+                dj["type"] = decorators::composition::label;
+            else
+                dj["type"] = decorators::association::label;
+            dj["multiplicity"] = r->multiplicity;
+        }
+        else {
+            continue;
+        }
+
+        result.push_back(std::move(dj));
+    }
+
+    return result;
+}
+
+void import_decorators(const nlohmann::json &j, model::decorated_element &e)
+{
+    if (!j.contains("decorators"))
+        return;
+
+    std::vector<std::shared_ptr<decorators::decorator>> result;
+
+    for (const auto &dj : j.at("decorators")) {
+        const auto type = dj.at("type").get<std::string>();
+
+        std::shared_ptr<decorators::decorator> d;
+        if (type == decorators::note::label) {
+            auto n = std::make_shared<decorators::note>();
+            n->position = dj.at("position").get<std::string>();
+            n->text = dj.at("text").get<std::string>();
+            d = n;
+        }
+        else if (type == decorators::skip::label) {
+            d = std::make_shared<decorators::skip>();
+        }
+        else if (type == decorators::skip_relationship::label) {
+            d = std::make_shared<decorators::skip_relationship>();
+        }
+        else if (type == decorators::style::label) {
+            auto s = std::make_shared<decorators::style>();
+            s->spec = dj.at("spec").get<std::string>();
+            d = s;
+        }
+        else if (type == decorators::call::label) {
+            auto c = std::make_shared<decorators::call>();
+            c->callee = dj.at("callee").get<std::string>();
+            d = c;
+        }
+        else {
+            std::shared_ptr<decorators::relationship> r;
+            if (type == decorators::aggregation::label)
+                r = std::make_shared<decorators::aggregation>();
+            else if (type == decorators::composition::label)
+                r = std::make_shared<decorators::composition>();
+            else if (type == decorators::association::label)
+                r = std::make_shared<decorators::association>();
+            else
+                throw std::runtime_error(fmt::format(
+                    "Invalid decorator '{}' in partial model", type));
+            r->multiplicity = dj.at("multiplicity").get<std::string>();
+            d = r;
+        }
+
+        d->diagrams = dj.at("diagrams").get<std::vector<std::string>>();
+        result.emplace_back(std::move(d));
+    }
+
+    e.add_decorators(result);
+}
+
+void export_style(const model::stylable_element &e, nlohmann::json &j)
+{
+    if (const auto &style = e.style(); style)
+        j["style"] = style.value();
+}
+
+void import_style(const nlohmann::json &j, model::stylable_element &e)
+{
+    if (j.contains("style"))
+        e.set_style(j.at("style").get<std::string>());
+}
+
+nlohmann::json export_template_parameter(const template_parameter &tp)
+{
+    nlohmann::json j;
+    j["kind"] = to_string(tp.kind());
+
+    // Names and types of variadic parameters are returned with '...'
+    if (const auto &t = tp.type(); t)
+        j["type"] = tp.is_variadic() ? strip_variadic(t.value()) : t.value();
+    if (const auto &n = tp.name(); n) {
+        if (tp.kind() == template_parameter_kind_t::template_type &&
+            n.value() == "typename")
+            j["name"] = "";
+        else if (tp.is_variadic() &&
+            tp.kind() != template_parameter_kind_t::non_type_template)
+            j["name"] = strip_variadic(n.value());
+        else
+            j["name"] = n.value();
+    }
+    if (const auto &d = tp.default_value(); d)
+        j["default"] = d.value();
+    if (const auto &c = tp.concept_constraint(); c)
+        j["concept_constraint"] = c.value();
+    if (const auto &id = tp.id(); id)
+        j["id"] = export_id(id.value());
+
+    j["is_variadic"] = tp.is_variadic();
+    j["is_template_parameter"] = tp.is_template_parameter();
+    j["is_template_template_parameter"] = tp.is_template_template_parameter();
+    j["is_ellipsis"] = tp.is_ellipsis();
+    j["is_function_template"] = tp.is_function_template();
+    j["is_data_pointer"] = tp.is_data_pointer();
+    j["is_member_pointer"] = tp.is_member_pointer();
+    j["is_array"] = tp.is_array();
+    j["is_unexposed"] = tp.is_unexposed();
+
+    auto deduced_context = nlohmann::json::array();
+    for (const auto &c : tp.deduced_context()) {
+        deduced_context.push_back({{"is_const", c.is_const},
+            {"is_volatile", c.is_volatile}, {"is_ref_const", c.is_ref_const},
+            {"is_ref_volatile", c.is_ref_volatile},
+            {"qualifier", to_string(c.pr)}});
+    }
+    j["deduced_context"] = std::move(deduced_context);
+
+    auto template_parameters = nlohmann::json::array();
+    for (const auto &p : tp.template_params())
+        template_parameters.push_back(export_template_parameter(p));
+    j["template_parameters"] = std::move(template_parameters);
+
+    return j;
+}
+
+template_parameter import_template_parameter(const nlohmann::json &j)
+{
+    const auto kind = enum_from_string(j.at("kind").get<std::string>(),
+        {template_parameter_kind_t::template_type,
+            template_parameter_kind_t::template_template_type,
+            template_parameter_kind_t::non_type_template,
+            template_parameter_kind_t::argument,
+            template_parameter_kind_t::concept_constraint});
+
+    auto tp = template_parameter::make_template_type({});
+
+    // Non-type template parameters accept a type, name and default value,
+    // the actual kind is set once they are restored
+    tp.set_kind(template_parameter_kind_t::non_type_template);
+    if (const auto t = get_optional<std::string>(j, "type"); t)
+        tp.set_type(t.value());
+    if (const auto n = get_optional<std::string>(j, "name"); n)
+        // An empty name can only be set with variadic suffix, which is
+        // restored below
+        tp.set_name(n.value().empty() ? "..." : n.value());
+    if (const auto d = get_optional<std::string>(j, "default"); d)
+        tp.set_default_value(d.value());
+    tp.set_kind(kind);
+
+    if (const auto c = get_optional<std::string>(j, "concept_constraint"); c)
+        tp.set_concept_constraint(c.value());
+    if (j.contains("id"))
+        tp.set_id(import_id(j.at("id")));
+
+    tp.is_variadic(j.at("is_variadic").get<bool>());
+    tp.is_template_parameter(j.at("is_template_parameter").get<bool>());
+    tp.is_template_template_parameter(
+        j.at("is_template_template_parameter").get<bool>());
+    tp.is_ellipsis(j.at("is_ellipsis").get<bool>());
+    tp.is_function_template(j.at("is_function_template").get<bool>());
+    tp.is_data_pointer(j.at("is_data_pointer").get<bool>());
+    tp.is_member_pointer(j.at("is_member_pointer").get<bool>());
+    tp.is_array(j.at("is_array").get<bool>());
+    tp.set_unexposed(j.at("is_unexposed").get<bool>());
+
+    std::vector<context> deduced_context;
+    for (const auto &cj : j.at("deduced_context")) {
+        context c;
+        c.is_const = cj.at("is_const").get<bool>();
+        c.is_volatile = cj.at("is_volatile").get<bool>();
+        c.is_ref_const = cj.at("is_ref_const").get<bool>();
+        c.is_ref_volatile = cj.at("is_ref_volatile").get<bool>();
+        c.pr = rpqualifier_from_string(cj.at("qualifier").get<std::string>());
+        deduced_context.push_back(c);
+    }
+    tp.deduced_context(std::move(deduced_context));
+
+    for (const auto &pj : j.at("template_parameters"))
+        tp.add_template_param(import_template_parameter(pj));
+
+    return tp;
+}
+
+nlohmann::json export_template_parameters(const model::template_trait &t)
+{
+    auto result = nlohmann::json::array();
+    for (const auto &tp : t.template_params())
+        result.push_back(export_template_parameter(tp));
+
+    return result;
+}
+
+void import_template_parameters(
+    const nlohmann::json &j, model::template_trait &t)
+{
+    for (const auto &tp : j.at("template_parameters"))
+        t.add_template(import_template_parameter(tp));
+}
+
+void export_template_element(
+    const model::template_element &e, nlohmann::json &j)
+{
+    j["is_template"] = e.is_template();
+    j["template_specialization_found"] = e.template_specialization_found();
+    j["template_parameters"] = export_template_parameters(e);
+}
+
+void import_template_element(
+    const nlohmann::json &j, model::template_element &e)
+{
+    e.is_template(j.at("is_template").get<bool>());
+    e.template_specialization_found(
+        j.at("template_specialization_found").get<bool>());
+    import_template_parameters(j, e);
+}
+
+nlohmann::json export_relationship(const model::relationship &r)
+{
+    nlohmann::json j;
+    j["type"] = to_string(r.type());
+    j["destination"] = export_id(r.destination());
+    if (!r.multiplicity_source().empty())
+        j["multiplicity_source"] = r.multiplicity_source();
+    if (!r.multiplicity_destination().empty())
+        j["multiplicity_destination"] = r.multiplicity_destination();
+    if (r.access() != access_t::kNone)
+        j["access"] = to_string(r.access());
+    if (!r.label().empty())
+        j["label"] = r.label();
+
+    export_decorated_element(r, j);
+    export_style(r, j);
+
+    return j;
+}
+
+model::relationship import_relationship(const nlohmann::json &j)
+{
+    model::relationship r{import_relationship_type(j.at("type")),
+        import_id(j.at("destination")),
+        j.contains("access") ? import_access(j.at("access")) : access_t::kNone,
+        j.value("label", std::string{}),
+        j.value("multiplicity_source", std::string{}),
+        j.value("multiplicity_destination", std::string{})};
+
+    import_decorated_element(j, r);
+    import_style(j, r);
+
+    return r;
+}
+
+void export_diagram_element(const model::diagram_element &e, nlohmann::json &j)
+{
+    j["id"] = export_id(e.id());
+    j["name"] = e.name();
+    j["type"] = e.type_name();
+    if (const auto &parent_id = e.parent_element_id(); parent_id)
+        j["parent_element_id"] = export_id(parent_id.value());
+    j["is_nested"] = e.is_nested();
+    j["is_complete"] = e.complete();
+
+    auto relationships = nlohmann::json::array();
+    for (const auto &r : e.relationships()) {
+        if (r.destination().is_global())
+            relationships.push_back(export_relationship(r));
+    }
+    j["relationships"] = std::move(relationships);
+
+    export_source_location(e, j);
+    export_decorated_element(e, j);
+}
+
+void import_diagram_element(const nlohmann::json &j, model::diagram_element &e)
+{
+    e.set_id(import_id(j.at("id")));
+    e.set_name(j.at("name").get<std::string>());
+    if (j.contains("parent_element_id"))
+        e.set_parent_element_id(import_id(j.at("parent_element_id")));
+    e.nested(j.at("is_nested").get<bool>());
+    e.complete(j.at("is_complete").get<bool>());
+
+    import_source_location(j, e);
+    import_decorated_element(j, e);
+    import_relationships(j, e);
+}
+
+void import_relationships(const nlohmann::json &j, model::diagram_element &e)
+{
+    for (const auto &r : j.at("relationships"))
+        e.add_relationship(import_relationship(r));
+}
+
+void export_element(const model::element &e, nlohmann::json &j)
+{
+    export_diagram_element(e, j);
+
+    j["namespace"] = export_path(e.get_namespace());
+    j["using_namespace"] = export_path(e.using_namespace());
+    if (const auto &module = e.module(); module) {
+        j["module"]["name"] = module.value();
+        j["module"]["is_private"] = e.module_private();
+    }
+}
+
+void import_element(const nlohmann::json &j, model::element &e)
+{
+    import_diagram_element(j, e);
+
+    e.set_namespace(import_path(j.at("namespace")));
+    if (j.contains("module")) {
+        e.set_module(j.at("module").at("name").get<std::string>());
+        e.set_module_private(j.at("module").at("is_private").get<bool>());
+    }
+}
+
+nlohmann::json export_package(const model::package &p)
+{
+    nlohmann::json j;
+    export_element(p, j);
+    export_style(p, j);
+    j["is_deprecated"] = p.is_deprecated();
+
+    return j;
+}
+
+std::unique_ptr<model::package> import_package(const nlohmann::json &j)
+{
+    const auto ns = import_path(j.at("namespace"));
+
+    auto p = std::make_unique<model::package>(
+        import_path(j.at("using_namespace")), ns.type());
+    import_element(j, *p);
+    import_style(j, *p);
+    p->set_deprecated(j.at("is_deprecated").get<bool>());
+
+    return p;
+}
+
+std::vector<nlohmann::json> merge_elements(
+    const std::vector<nlohmann::json> &partial_models, const std::string &key)
+{
+    // Select the entry of each element and collect relationships of all its
+    // entries in the order of shards
+    std::map<std::string, const nlohmann::json *> selected;
+    std::map<std::string, nlohmann::json> relationships;
+    for (const auto &partial_model : partial_models) {
+        for (const auto &e : partial_model.at(key)) {
+            const auto id = e.at("id").get<std::string>();
+
+            auto it = selected.find(id);
+            if (it == selected.end())
+                selected.emplace(id, &e);
+            else if (!it->second->at("is_complete").get<bool>() &&
+                e.at("is_complete").get<bool>())
+                it->second = &e;
+
+            auto &element_relationships =
+                relationships.try_emplace(id, nlohmann::json::array())
+                    .first->second;
+            for (const auto &r : e.at("relationships"))
+                element_relationships.push_back(r);
+        }
+    }
+
+    std::vector<nlohmann::json> result;
+    for (const auto &partial_model : partial_models) {
+        for (const auto &e : partial_model.at(key)) {
+            const auto id = e.at("id").get<std::string>();
+            if (selected.at(id) != &e)
+                continue;
+
+            auto &merged = result.emplace_back(e);
+            merged["relationships"] = std::move(relationships.at(id));
+        }
+    }
+
+    return result;
+}
+
+} // namespace clanguml::common::generators::json
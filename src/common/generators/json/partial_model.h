@@ -0,0 +1,327 @@
+/**
+ * @file src/common/generators/json/partial_model.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "common/model/element.h"
+#include "common/model/element_view.h"
+#include "common/model/enums.h"
+#include "common/model/nested_trait.h"
+#include "common/model/package.h"
+#include "common/model/relationship.h"
+#include "common/model/stylable_element.h"
+#include "common/model/template_element.h"
+#include "common/model/template_parameter.h"
+#include "util/util.h"
+
+#include <nlohmann/json.hpp>
+
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Partial models are written by diagram shards (`--shard i/N`) and merged
+// into a complete diagram model by `clang-uml merge`. They follow the schema
+// of the JSON generators (e.g. ids are strings and enums are written using
+// their `to_string()` names), extended with all properties needed to restore
+// the diagram model.
+namespace clanguml::common::generators::json {
+
+/**
+ * @brief Find enum value by its `to_string()` name
+ *
+ * @tparam T Enum type
+ * @param name Name of the enum value
+ * @param values All values of the enum
+ * @return Enum value
+ */
+template <typename T>
+T enum_from_string(const std::string &name, std::initializer_list<T> values)
+{
+    for (const auto value : values) {
+        if (to_string(value) == name)
+            return value;
+    }
+
+    throw std::runtime_error(
+        fmt::format("Invalid value '{}' in partial model", name));
+}
+
+/**
+ * @brief Export global element id as a string, like the JSON generators
+ */
+nlohmann::json export_id(eid_t id);
+
+/**
+ * @brief Import global element id
+ */
+eid_t import_id(const nlohmann::json &j);
+
+/**
+ * @brief Import access specifier from its `to_string()` name
+ */
+model::access_t import_access(const nlohmann::json &j);
+
+/**
+ * @brief Import relationship type from its `to_string()` name
+ */
+model::relationship_t import_relationship_type(const nlohmann::json &j);
+
+/**
+ * @brief Export path with its type
+ *
+ * Path elements are exported separately, as module partitions cannot be
+ * restored from the path string.
+ */
+nlohmann::json export_path(const model::path &p);
+
+/**
+ * @brief Import path with its type
+ */
+model::path import_path(const nlohmann::json &j);
+
+/**
+ * @brief Export source location of an element
+ */
+void export_source_location(
+    const model::source_location &sl, nlohmann::json &j);
+
+/**
+ * @brief Import source location of an element
+ */
+void import_source_location(
+    const nlohmann::json &j, model::source_location &sl);
+
+/**
+ * @brief Export comment and decorators (e.g. `@uml{note}`) of an element
+ */
+void export_decorated_element(
+    const model::decorated_element &e, nlohmann::json &j);
+
+/**
+ * @brief Import comment and decorators of an element
+ */
+void import_decorated_element(
+    const nlohmann::json &j, model::decorated_element &e);
+
+/**
+ * @brief Export decorators (e.g. `@uml{note}`) of an element
+ */
+nlohmann::json export_decorators(const model::decorated_element &e);
+
+/**
+ * @brief Import decorators of an element
+ */
+void import_decorators(const nlohmann::json &j, model::decorated_element &e);
+
+/**
+ * @brief Export style of an element, if any
+ */
+void export_style(const model::stylable_element &e, nlohmann::json &j);
+
+/**
+ * @brief Import style of an element, if any
+ */
+void import_style(const nlohmann::json &j, model::stylable_element &e);
+
+/**
+ * @brief Export template parameter, including its nested parameters
+ */
+nlohmann::json export_template_parameter(const model::template_parameter &tp);
+
+/**
+ * @brief Import template parameter, including its nested parameters
+ */
+model::template_parameter import_template_parameter(const nlohmann::json &j);
+
+/**
+ * @brief Export template parameters of an element
+ */
+nlohmann::json export_template_parameters(const model::template_trait &t);
+
+/**
+ * @brief Import template parameters of an element
+ */
+void import_template_parameters(
+    const nlohmann::json &j, model::template_trait &t);
+
+/**
+ * @brief Export template parameters and flags of a template element
+ */
+void export_template_element(
+    const model::template_element &e, nlohmann::json &j);
+
+/**
+ * @brief Import template parameters and flags of a template element
+ */
+void import_template_element(
+    const nlohmann::json &j, model::template_element &e);
+
+/**
+ * @brief Export relationship, including its decorators and style
+ */
+nlohmann::json export_relationship(const model::relationship &r);
+
+/**
+ * @brief Import relationship, including its decorators and style
+ */
+model::relationship import_relationship(const nlohmann::json &j);
+
+/**
+ * @brief Export properties common to all diagram elements
+ *
+ * Relationships to elements, whose id was not resolved to a global id, are
+ * skipped, as they cannot be resolved in other shards either.
+ */
+void export_diagram_element(
+    const model::diagram_element &e, nlohmann::json &j);
+
+/**
+ * @brief Import properties common to all diagram elements
+ */
+void import_diagram_element(
+    const nlohmann::json &j, model::diagram_element &e);
+
+/**
+ * @brief Import relationships of a diagram element
+ *
+ * Relationships, which the element already has, are skipped.
+ */
+void import_relationships(const nlohmann::json &j, model::diagram_element &e);
+
+/**
+ * @brief Export properties common to all namespaced elements
+ */
+void export_element(const model::element &e, nlohmann::json &j);
+
+/**
+ * @brief Import properties common to all namespaced elements
+ */
+void import_element(const nlohmann::json &j, model::element &e);
+
+/**
+ * @brief Create an element and import its properties common to all
+ *        namespaced elements
+ */
+template <typename T>
+std::unique_ptr<T> make_element(const nlohmann::json &j)
+{
+    auto e = std::make_unique<T>(import_path(j.at("using_namespace")));
+    import_element(j, *e);
+    return e;
+}
+
+/**
+ * @brief Export package
+ */
+nlohmann::json export_package(const model::package &p);
+
+/**
+ * @brief Import package
+ */
+std::unique_ptr<model::package> import_package(const nlohmann::json &j);
+
+/**
+ * @brief Export elements of a diagram element tree
+ *
+ * Elements are exported in pre-order, i.e. each package precedes its
+ * elements, with the path of their parent package in the tree.
+ *
+ * @param tree Diagram element tree
+ * @param export_element Function exporting a single element
+ * @param elements List to add the exported elements to
+ * @param parent Path of the parent package in the tree
+ */
+template <typename F>
+void export_elements(
+    const model::nested_trait<model::element, model::namespace_> &tree,
+    const F &export_element, nlohmann::json &elements,
+    const std::vector<std::string> &parent = {})
+{
+    using nested_trait_ns =
+        model::nested_trait<model::element, model::namespace_>;
+
+    for (const auto &e : tree) {
+        auto j = export_element(*e);
+        j["parent"] = parent;
+        elements.push_back(std::move(j));
+
+        if (const auto *nested = dynamic_cast<const nested_trait_ns *>(e.get());
+            nested != nullptr) {
+            auto path = parent;
+            path.push_back(e->name());
+            export_elements(*nested, export_element, elements, path);
+        }
+    }
+}
+
+/**
+ * @brief Combine elements of partial models into a list of elements
+ *        to import
+ *
+ * Elements found in multiple partial models (e.g. declared in a header
+ * included from translation units in different shards) are imported once,
+ * using the first entry of a complete element (i.e. not a forward
+ * declaration) or the first entry if none is complete, and with the
+ * relationships of all entries. Elements are returned in the order of their
+ * selected entries.
+ *
+ * @param partial_models Partial models of all shards, in shard order
+ * @param key Key of the elements list in each partial model
+ * @return Elements to import
+ */
+std::vector<nlohmann::json> merge_elements(
+    const std::vector<nlohmann::json> &partial_models, const std::string &key);
+
+/**
+ * @brief Add element imported from a partial model to a diagram element tree
+ *
+ * The element is added at its `parent` path in the tree, which was exported
+ * before the element itself. Elements which cannot be added to the tree are
+ * skipped with a warning, just like by the translation unit visitors.
+ *
+ * @param diagram Diagram model
+ * @param j Partial model of the element
+ * @param e Element
+ */
+template <typename ElementT, typename DiagramT>
+void add_element(
+    DiagramT &diagram, const nlohmann::json &j, std::unique_ptr<ElementT> e)
+{
+    const auto parent = j.at("parent").get<std::vector<std::string>>();
+    const model::namespace_ parent_path{parent.cbegin(), parent.cend()};
+
+    try {
+        auto &e_ref = *e;
+        if (diagram.add_element(parent_path, std::move(e))) {
+            if constexpr (std::is_base_of_v<model::element_view<ElementT>,
+                              DiagramT>) {
+                static_cast<model::element_view<ElementT> &>(diagram).add(
+                    std::ref(e_ref));
+            }
+        }
+    }
+    catch (const std::runtime_error &ex) {
+        LOG_WARN("Cannot add {} {} from partial model: {}",
+            j.at("type").template get<std::string>(),
+            j.at("name").template get<std::string>(), ex.what());
+    }
+}
+
+} // namespace clanguml::common::generators::json
@@ -0,0 +1,287 @@
+/**
+ * @file src/common/generators/manifest.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "manifest.h"
+
+#include "util/util.h"
+#include "version.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+
+namespace clanguml::common::generators {
+
+namespace {
+std::string to_hex(std::uint64_t hash) { return fmt::format("{:016x}", hash); }
+
+std::optional<std::string> content_hash(const std::string &path)
+{
+    std::ifstream ifs{path, std::ios::binary};
+    if (!ifs)
+        return {};
+
+    std::stringstream buffer;
+    buffer << ifs.rdbuf();
+
+    return to_hex(util::stable_hash(buffer.str()));
+}
+
+void emit_diagram_config(
+    YAML::Emitter &out, const clanguml::config::diagram &diagram)
+{
+    using clanguml::common::model::diagram_t;
+
+    if (diagram.type() == diagram_t::kClass) {
+        out << dynamic_cast<const config::class_diagram &>(diagram);
+    }
+    else if (diagram.type() == diagram_t::kSequence) {
+        out << dynamic_cast<const config::sequence_diagram &>(diagram);
+    }
+    else if (diagram.type() == diagram_t::kInclude) {
+        out << dynamic_cast<const config::include_diagram &>(diagram);
+    }
+    else if (diagram.type() == diagram_t::kPackage) {
+        out << dynamic_cast<const config::package_diagram &>(diagram);
+    }
+}
+} // namespace
+
+manifest::manifest(std::filesystem::path path)
+    : path_{std::move(path)}
+{
+    std::ifstream ifs{path_};
+    if (!ifs)
+        return;
+
+    try {
+        const auto j = nlohmann::json::parse(ifs);
+
+        for (const auto &[name, diagram] : j.at("diagrams").items()) {
+            auto &e = entries_[name];
+            e.fingerprint = diagram.at("fingerprint").get<std::string>();
+            for (const auto &[file, s] : diagram.at("files").items()) {
+                file_stamp recorded{s.at("hash").get<std::string>(),
+                    s.at("size").get<std::uintmax_t>(),
+                    s.at("mtime").get<std::int64_t>()};
+                stamps_[file] = recorded;
+                e.files.emplace(file, std::move(recorded));
+            }
+        }
+    }
+    catch (const nlohmann::json::exception &e) {
+        LOG_WARN("Ignoring invalid manifest {}: {}", path_.string(), e.what());
+        entries_.clear();
+        stamps_.clear();
+    }
+}
+
+std::optional<manifest::file_stamp> manifest::stamp(
+    const std::string &path) const
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return {};
+
+    const auto mtime = static_cast<std::int64_t>(
+        std::filesystem::last_write_time(path, ec)
+            .time_since_epoch()
+            .count());
+    if (ec)
+        return {};
+
+    {
+        std::lock_guard<std::mutex> l{stamps_mutex_};
+
+        const auto it = stamps_.find(path);
+        if (it != stamps_.end() && it->second.size == size &&
+            it->second.mtime == mtime)
+            return it->second;
+    }
+
+    auto hash = content_hash(path);
+    if (!hash)
+        return {};
+
+    // If the file was modified while being hashed, the hash may not match
+    // the recorded modification time, so don't keep it
+    const auto mtime_after = static_cast<std::int64_t>(
+        std::filesystem::last_write_time(path, ec)
+            .time_since_epoch()
+            .count());
+    if (ec || mtime_after != mtime)
+        return file_stamp{std::move(*hash), size, mtime_after};
+
+    file_stamp result{std::move(*hash), size, mtime};
+
+    std::lock_guard<std::mutex> l{stamps_mutex_};
+    stamps_[path] = result;
+
+    return result;
+}
+
+bool manifest::is_up_to_date(
+    const std::string &diagram_name, const std::string &fingerprint) const
+{
+    std::map<std::string, file_stamp> files;
+
+    {
+        std::lock_guard<std::mutex> l{mutex_};
+
+        const auto it = entries_.find(diagram_name);
+        if (it == entries_.end() || it->second.fingerprint != fingerprint)
+            return false;
+
+        files = it->second.files;
+    }
+
+    // Files are checked without holding the lock, so that diagrams can be
+    // checked and updated in parallel
+    return std::all_of(files.begin(), files.end(), [this](const auto &file) {
+        const auto current = stamp(file.first);
+        return current && current->hash == file.second.hash;
+    });
+}
+
+std::set<std::string> manifest::files(const std::string &diagram_name) const
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    std::set<std::string> result;
+
+    const auto it = entries_.find(diagram_name);
+    if (it != entries_.end()) {
+        for (const auto &[file, s] : it->second.files)
+            result.emplace(file);
+    }
+
+    return result;
+}
+
+void manifest::update(const std::string &diagram_name,
+    std::string fingerprint, const std::set<std::string> &files,
+    std::filesystem::file_time_type started)
+{
+    entry e{std::move(fingerprint), {}};
+
+    // Modification times are truncated by some file systems, so files
+    // saved shortly after the diagram generation started can appear older
+    const auto modified_since =
+        (started - kModificationTimeResolution).time_since_epoch().count();
+
+    // Files are checked before taking the lock, as this can take a while
+    // for large diagrams
+    for (const auto &file : files) {
+        auto s = stamp(file);
+        if (!s)
+            continue;
+
+        if (s->mtime >= modified_since) {
+            LOG_INFO("File {} was modified while generating diagram {} - "
+                     "it will be generated again in the next run",
+                file, diagram_name);
+            remove(diagram_name);
+            return;
+        }
+
+        e.files.emplace(file, std::move(*s));
+    }
+
+    std::lock_guard<std::mutex> l{mutex_};
+    entries_[diagram_name] = std::move(e);
+}
+
+void manifest::remove(const std::string &diagram_name)
+{
+    std::lock_guard<std::mutex> l{mutex_};
+    entries_.erase(diagram_name);
+}
+
+void manifest::write() const
+{
+    std::lock_guard<std::mutex> l{mutex_};
+    std::lock_guard<std::mutex> sl{stamps_mutex_};
+
+    nlohmann::json diagrams = nlohmann::json::object();
+    for (const auto &[name, e] : entries_) {
+        nlohmann::json files = nlohmann::json::object();
+        for (const auto &[file, s] : e.files) {
+            // Files touched without changing their contents are recorded
+            // with their current modification time, so that they are not
+            // hashed again in the next run
+            const auto it = stamps_.find(file);
+            const auto &current =
+                it != stamps_.end() && it->second.hash == s.hash ? it->second
+                                                                  : s;
+            files[file] = {{"hash", current.hash}, {"size", current.size},
+                {"mtime", current.mtime}};
+        }
+
+        diagrams[name] = {
+            {"fingerprint", e.fingerprint}, {"files", std::move(files)}};
+    }
+
+    std::ofstream ofs{path_};
+    ofs << nlohmann::json{{"diagrams", std::move(diagrams)}}.dump(2);
+
+    if (!ofs)
+        LOG_WARN("Failed to write manifest {}", path_.string());
+}
+
+std::string diagram_fingerprint(const clanguml::config::diagram &diagram,
+    const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    const cli::runtime_config &runtime_config)
+{
+    std::string inputs;
+    auto add = [&inputs](std::string_view value) {
+        inputs.append(value);
+        inputs.push_back('\0');
+    };
+
+    add(clanguml::version::CLANG_UML_VERSION);
+
+    // Diagram options are already merged with the inherited ones, so the
+    // emitted configuration is the effective configuration of the diagram
+    YAML::Emitter out;
+    emit_diagram_config(out, diagram);
+    add(out.c_str());
+
+    for (const auto generator_type : runtime_config.generators)
+        add(to_string(generator_type));
+
+    add(runtime_config.render_diagrams ? "render" : "");
+
+    for (const auto &tu : translation_units) {
+        for (const auto &command : db.getCompileCommands(tu)) {
+            add(command.Directory);
+            add(command.Filename);
+            for (const auto &argument : command.CommandLine)
+                add(argument);
+        }
+    }
+
+    return to_hex(util::stable_hash(inputs));
+}
+
+} // namespace clanguml::common::generators
@@ -0,0 +1,160 @@
+/**
+ * @file src/common/generators/manifest.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "cli/cli_handler.h"
+#include "common/compilation_database.h"
+#include "config/config.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Fingerprints of diagram inputs from the previous run
+ *
+ * For each generated diagram, the manifest stores the fingerprint of its
+ * configuration and compile commands, along with content hashes of all
+ * files read while generating the diagram. If neither has changed, the
+ * diagram does not have to be generated again.
+ *
+ * Files are only hashed if their size or modification time differs from
+ * the recorded one, and each file is hashed at most once per run, even if
+ * it is read by many diagrams.
+ */
+class manifest {
+public:
+    /*! Name of the manifest file in the output directory */
+    static constexpr const char *kFileName{"clang-uml-manifest.json"};
+
+    /*! Coarsest modification time resolution of supported file systems */
+    static constexpr std::chrono::seconds kModificationTimeResolution{2};
+
+    /**
+     * @brief Constructor
+     *
+     * Loads the manifest file, if it exists.
+     *
+     * @param path Path to the manifest file
+     */
+    explicit manifest(std::filesystem::path path);
+
+    /**
+     * @brief Check whether the diagram inputs are the same as during the
+     *        previous run
+     *
+     * @param diagram_name Name of the diagram
+     * @param fingerprint Current fingerprint of the diagram
+     * @return True, if the diagram does not have to be generated again
+     */
+    bool is_up_to_date(
+        const std::string &diagram_name, const std::string &fingerprint) const;
+
+    /**
+     * @brief Get files read while generating the diagram in the previous run
+     *
+     * @param diagram_name Name of the diagram
+     * @return Set of file paths
+     */
+    std::set<std::string> files(const std::string &diagram_name) const;
+
+    /**
+     * @brief Record inputs of a successfully generated diagram
+     *
+     * If any of the files was modified after the diagram generation started,
+     * the diagram model may not reflect its current contents. In such case
+     * the diagram is removed from the manifest, so that it is generated
+     * again in the next run.
+     *
+     * @param diagram_name Name of the diagram
+     * @param fingerprint Fingerprint of the diagram
+     * @param files Files read while generating the diagram
+     * @param started Time when the diagram generation started
+     */
+    void update(const std::string &diagram_name, std::string fingerprint,
+        const std::set<std::string> &files,
+        std::filesystem::file_time_type started);
+
+    /**
+     * @brief Remove diagram from the manifest, e.g. after it failed
+     *
+     * @param diagram_name Name of the diagram
+     */
+    void remove(const std::string &diagram_name);
+
+    /**
+     * @brief Write the manifest file
+     */
+    void write() const;
+
+private:
+    struct file_stamp {
+        std::string hash;
+        std::uintmax_t size{};
+        std::int64_t mtime{};
+    };
+
+    struct entry {
+        std::string fingerprint;
+        std::map<std::string, file_stamp> files;
+    };
+
+    /**
+     * @brief Get current stamp of a file, hashing it only if necessary
+     *
+     * @param path Path to the file
+     * @return Stamp of the file, or empty optional if it cannot be read
+     */
+    std::optional<file_stamp> stamp(const std::string &path) const;
+
+    std::filesystem::path path_;
+    std::map<std::string, entry> entries_;
+    mutable std::mutex mutex_;
+
+    // Latest known stamps of all files, shared by all diagrams
+    mutable std::map<std::string, file_stamp> stamps_;
+    mutable std::mutex stamps_mutex_;
+};
+
+/**
+ * @brief Calculate fingerprint of diagram inputs, other than source files
+ *
+ * The fingerprint covers the clang-uml version, the effective diagram
+ * configuration, the translation units and their compile commands, and
+ * runtime options affecting diagram outputs.
+ *
+ * @param diagram Effective diagram configuration
+ * @param db Reference to compilation database
+ * @param translation_units List of translation units for the diagram
+ * @param runtime_config Runtime configuration
+ * @return Fingerprint as hex string
+ */
+std::string diagram_fingerprint(const clanguml::config::diagram &diagram,
+    const common::compilation_database &db,
+    const std::vector<std::string> &translation_units,
+    const cli::runtime_config &runtime_config);
+
+} // namespace clanguml::common::generators
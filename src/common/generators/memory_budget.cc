@@ -0,0 +1,123 @@
+/**
+ * @file src/common/generators/memory_budget.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_budget.h"
+
+#include <chrono>
+#include <fstream>
+
+#if defined(__linux)
+#include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+namespace clanguml::common::generators {
+
+namespace {
+constexpr auto kPollInterval = std::chrono::milliseconds{100};
+constexpr std::uint64_t kKilobytesPerMegabyte{1024};
+constexpr std::uint64_t kBytesPerKilobyte{1024};
+} // namespace
+
+memory_budget::memory_budget(std::uint64_t limit_mb)
+    : limit_kb_{limit_mb * kKilobytesPerMegabyte}
+{
+}
+
+void memory_budget::acquire()
+{
+    std::unique_lock<std::mutex> l{mutex_};
+
+    // Memory usage changes without notifications, so it has to be polled
+    while (running_ > 0 && current_rss_kb() >= limit_kb_) {
+        released_.wait_for(l, kPollInterval);
+    }
+
+    running_++;
+}
+
+void memory_budget::release()
+{
+    {
+        std::lock_guard<std::mutex> l{mutex_};
+        running_--;
+    }
+
+    released_.notify_all();
+}
+
+void memory_budget::checkpoint()
+{
+    release();
+
+#if defined(__GLIBC__)
+    // Return memory freed with the previous translation unit AST to the
+    // system, otherwise it would still count towards the resident set size
+    malloc_trim(0);
+#endif
+
+    acquire();
+}
+
+std::uint64_t memory_budget::limit_kb() const { return limit_kb_; }
+
+std::uint64_t memory_budget::current_rss_kb()
+{
+#if defined(__linux)
+    std::ifstream statm{"/proc/self/statm"};
+    std::uint64_t size{0};
+    std::uint64_t resident{0};
+    if (!(statm >> size >> resident))
+        return 0;
+
+    return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE)) /
+        kBytesPerKilobyte;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+            reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+        return 0;
+
+    return info.resident_size / kBytesPerKilobyte;
+#else
+    return 0;
+#endif
+}
+
+memory_budget_guard::memory_budget_guard(memory_budget *budget)
+    : budget_{budget}
+{
+    if (budget_ != nullptr)
+        budget_->acquire();
+}
+
+memory_budget_guard::~memory_budget_guard()
+{
+    if (budget_ != nullptr)
+        budget_->release();
+}
+
+} // namespace clanguml::common::generators
@@ -0,0 +1,101 @@
+/**
+ * @file src/common/generators/memory_budget.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Limits the number of diagrams processed while memory is short
+ *
+ * Diagram generation tasks acquire the budget before they start and
+ * before each translation unit. When the resident set size of the process
+ * exceeds the limit, tasks wait until enough memory is released by the
+ * other tasks. At least one task is always allowed to run, so that the
+ * generation can progress even if a single diagram exceeds the limit.
+ */
+class memory_budget {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param limit_mb Memory limit in megabytes
+     */
+    explicit memory_budget(std::uint64_t limit_mb);
+
+    /**
+     * @brief Wait until the memory usage is below the limit or no other
+     *        task is running, and mark the calling task as running
+     */
+    void acquire();
+
+    /**
+     * @brief Mark the calling task as not running
+     */
+    void release();
+
+    /**
+     * @brief Release memory freed by the previous translation unit and
+     *        wait for the budget before processing the next one
+     */
+    void checkpoint();
+
+    /**
+     * @brief Memory limit
+     *
+     * @return Memory limit in kilobytes
+     */
+    std::uint64_t limit_kb() const;
+
+    /**
+     * @brief Current resident set size of the process
+     *
+     * @return Resident set size in kilobytes, or 0 if not supported on this
+     *         platform
+     */
+    static std::uint64_t current_rss_kb();
+
+private:
+    std::uint64_t limit_kb_;
+    unsigned running_{0};
+    std::mutex mutex_;
+    std::condition_variable released_;
+};
+
+/**
+ * @brief RAII helper acquiring memory budget for its lifetime
+ */
+class memory_budget_guard {
+public:
+    explicit memory_budget_guard(memory_budget *budget);
+
+    memory_budget_guard(const memory_budget_guard &) = delete;
+    memory_budget_guard(memory_budget_guard &&) = delete;
+    memory_budget_guard &operator=(const memory_budget_guard &) = delete;
+    memory_budget_guard &operator=(memory_budget_guard &&) = delete;
+
+    ~memory_budget_guard();
+
+private:
+    memory_budget *budget_;
+};
+
+} // namespace clanguml::common::generators
@@ -0,0 +1,208 @@
+/**
+ * @file src/common/generators/profiler.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "profiler.h"
+
+#include "util/util.h"
+
+#include <algorithm>
+#include <fstream>
+
+#if defined(__linux) || defined(__unix) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace clanguml::common::generators {
+
+namespace {
+std::string truncate_left(const std::string &s, size_t width)
+{
+    if (s.size() <= width)
+        return s;
+
+    return "..." + s.substr(s.size() - width + 3);
+}
+} // namespace
+
+diagram_profile &profiler::add_diagram(
+    const std::string &name, model::diagram_t type)
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    auto &result = diagrams_.emplace_back();
+    result.name = name;
+    result.type = type;
+
+    return result;
+}
+
+void profiler::set_compile_commands_adjustment_ms(double ms)
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    compile_commands_adjustment_ms_ = ms;
+}
+
+void profiler::set_render_ms(double commands_ms, double wait_ms)
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    render_commands_ms_ = commands_ms;
+    render_wait_ms_ = wait_ms;
+}
+
+void profiler::set_total_ms(double ms)
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    total_ms_ = ms;
+}
+
+void profiler::print(std::ostream &os, size_t max_translation_units) const
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    std::vector<const diagram_profile *> diagrams;
+    std::vector<std::pair<const diagram_profile *,
+        const translation_unit_profile *>>
+        translation_units;
+
+    for (const auto &d : diagrams_) {
+        diagrams.push_back(&d);
+        for (const auto &tu : d.translation_units)
+            translation_units.emplace_back(&d, &tu);
+    }
+
+    std::sort(diagrams.begin(), diagrams.end(),
+        [](const auto *a, const auto *b) { return a->total_ms > b->total_ms; });
+
+    std::sort(translation_units.begin(), translation_units.end(),
+        [](const auto &a, const auto &b) {
+            return a.second->total_ms > b.second->total_ms;
+        });
+
+    os << fmt::format("{:<32} {:>5} {:>10} {:>10} {:>10} {:>10}\n", "Diagram",
+        "TUs", "clang [ms]", "final [ms]", "gen [ms]", "total [ms]");
+
+    for (const auto *d : diagrams) {
+        double generators_ms{0};
+        for (const auto &[generator, ms] : d->generators_ms)
+            generators_ms += ms;
+
+        os << fmt::format(
+            "{:<32} {:>5} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n",
+            truncate_left(d->name, 32), d->translation_units.size(),
+            d->clang_ms, d->finalize_ms, generators_ms, d->total_ms);
+    }
+
+    os << '\n';
+
+    os << fmt::format("{:<46} {:>10} {:>10} {:>10} {:>10}\n",
+        "Translation unit (diagram)", "parse [ms]", "trav [ms]", "final [ms]",
+        "total [ms]");
+
+    for (size_t i = 0;
+         i < std::min(max_translation_units, translation_units.size()); i++) {
+        const auto &[d, tu] = translation_units[i];
+        os << fmt::format("{:<46} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n",
+            truncate_left(fmt::format("{} ({})", tu->path, d->name), 46),
+            tu->parse_ms, tu->traverse_ms, tu->finalize_ms, tu->total_ms);
+    }
+
+    os << '\n';
+
+    os << fmt::format("Compile commands adjustment: {:.1f} ms\n",
+        compile_commands_adjustment_ms_);
+    os << fmt::format("Render commands: {:.1f} ms (waited {:.1f} ms)\n",
+        render_commands_ms_, render_wait_ms_);
+    os << fmt::format("Total: {:.1f} ms, peak RSS: {:.1f} MB\n", total_ms_,
+        static_cast<double>(peak_rss_kb()) / 1024.0);
+}
+
+nlohmann::json profiler::to_json() const
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    nlohmann::json result;
+    result["total_ms"] = total_ms_;
+    result["compile_commands_adjustment_ms"] = compile_commands_adjustment_ms_;
+    result["render_commands_ms"] = render_commands_ms_;
+    result["render_wait_ms"] = render_wait_ms_;
+    result["peak_rss_kb"] = peak_rss_kb();
+    result["diagrams"] = nlohmann::json::array();
+
+    for (const auto &d : diagrams_) {
+        nlohmann::json dj;
+        dj["name"] = d.name;
+        dj["type"] = to_string(d.type);
+        dj["clang_ms"] = d.clang_ms;
+        dj["finalize_ms"] = d.finalize_ms;
+        dj["total_ms"] = d.total_ms;
+
+        dj["generators"] = nlohmann::json::object();
+        for (const auto &[generator, ms] : d.generators_ms)
+            dj["generators"][to_string(generator)] = ms;
+
+        dj["translation_units"] = nlohmann::json::array();
+        for (const auto &tu : d.translation_units) {
+            dj["translation_units"].push_back({{"path", tu.path},
+                {"parse_ms", tu.parse_ms}, {"traverse_ms", tu.traverse_ms},
+                {"finalize_ms", tu.finalize_ms}, {"total_ms", tu.total_ms}});
+        }
+
+        result["diagrams"].push_back(std::move(dj));
+    }
+
+    return result;
+}
+
+void profiler::write(const std::filesystem::path &path) const
+{
+    std::ofstream ofs;
+    ofs.open(path, std::ofstream::out | std::ofstream::trunc);
+    ofs << to_json().dump(2) << '\n';
+    ofs.close();
+
+    LOG_INFO("Written profile report to {}", path.string());
+}
+
+double profiler::elapsed_ms(clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(clock::now() - start)
+        .count();
+}
+
+long profiler::peak_rss_kb()
+{
+#if defined(__APPLE__)
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    // On macOS ru_maxrss is in bytes
+    return static_cast<long>(usage.ru_maxrss / 1024);
+#elif defined(__linux) || defined(__unix)
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return static_cast<long>(usage.ru_maxrss);
+#else
+    return 0;
+#endif
+}
+
+} // namespace clanguml::common::generators
@@ -0,0 +1,158 @@
+/**
+ * @file src/common/generators/profiler.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "common/model/enums.h"
+#include "common/types.h"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Timings of a single translation unit in a diagram
+ */
+struct translation_unit_profile {
+    /*! Path of the translation unit */
+    std::string path;
+    /*! Preprocessing, parsing and semantic analysis time */
+    double parse_ms{};
+    /*! Diagram visitor AST traversal time */
+    double traverse_ms{};
+    /*! Diagram visitor finalize() time */
+    double finalize_ms{};
+    /*! Total time of the frontend action */
+    double total_ms{};
+};
+
+/**
+ * @brief Timings of a single diagram
+ *
+ * Translation units of a diagram are processed sequentially, so the
+ * profile can be updated without synchronization, except for generator
+ * timings, which are stored in slots preallocated for each generator.
+ */
+struct diagram_profile {
+    /*! Name of the diagram */
+    std::string name;
+    /*! Type of the diagram */
+    model::diagram_t type{model::diagram_t::kClass};
+    /*! Total time of running the Clang tool on all translation units */
+    double clang_ms{};
+    /*! Diagram model finalize() time */
+    double finalize_ms{};
+    /*! Generator timings, in the order of generators in runtime config */
+    std::vector<std::pair<generator_type_t, double>> generators_ms;
+    /*! Total time of the diagram generation */
+    double total_ms{};
+    /*! Timings of translation units, in the order they were processed */
+    std::vector<translation_unit_profile> translation_units;
+};
+
+/**
+ * @brief Collects timings of diagram generation phases
+ *
+ * The profiler is enabled with the `--profile` command line option. At the
+ * end of the run it prints a summary table and writes the complete report
+ * in JSON format to the output directory.
+ *
+ * Peak memory usage is only reported for the whole process, as diagrams
+ * generated in parallel share the same address space.
+ */
+class profiler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Register a new diagram profile
+     *
+     * The returned reference is valid for the lifetime of the profiler.
+     *
+     * @param name Name of the diagram
+     * @param type Type of the diagram
+     * @return Reference to the diagram profile
+     */
+    diagram_profile &add_diagram(
+        const std::string &name, model::diagram_t type);
+
+    /**
+     * @brief Set the total time spent adjusting compile commands
+     */
+    void set_compile_commands_adjustment_ms(double ms);
+
+    /**
+     * @brief Set the total time spent in render commands and the time
+     *        spent waiting for them after all diagrams were generated
+     */
+    void set_render_ms(double commands_ms, double wait_ms);
+
+    /**
+     * @brief Set the total wall time of diagram generation
+     */
+    void set_total_ms(double ms);
+
+    /**
+     * @brief Print summary table with slowest diagrams and translation units
+     *
+     * @param os Output stream
+     * @param max_translation_units Maximum number of translation units listed
+     */
+    void print(std::ostream &os, size_t max_translation_units = 10) const;
+
+    /**
+     * @brief Convert complete profile to JSON
+     */
+    nlohmann::json to_json() const;
+
+    /**
+     * @brief Write complete profile as JSON to a file
+     *
+     * @param path Path of the output file
+     */
+    void write(const std::filesystem::path &path) const;
+
+    /**
+     * @brief Milliseconds elapsed since a time point
+     */
+    static double elapsed_ms(clock::time_point start);
+
+    /**
+     * @brief Peak resident set size of the current process
+     *
+     * @return Peak RSS in kilobytes, or 0 if not supported on this platform
+     */
+    static long peak_rss_kb();
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<diagram_profile> diagrams_;
+    double compile_commands_adjustment_ms_{};
+    double render_commands_ms_{};
+    double render_wait_ms_{};
+    double total_ms_{};
+};
+
+} // namespace clanguml::common::generators
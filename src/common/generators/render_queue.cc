@@ -0,0 +1,185 @@
+/**
+ * @file src/common/generators/render_queue.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render_queue.h"
+
+#include "util/trace.h"
+#include "util/util.h"
+
+namespace clanguml::common::generators {
+
+namespace {
+std::string command_template(
+    generator_type_t generator_type, const config::diagram &diagram)
+{
+    switch (generator_type) {
+    case generator_type_t::plantuml:
+        return diagram.puml().cmd;
+    case generator_type_t::mermaid:
+        return diagram.mermaid().cmd;
+    default:
+        return {};
+    };
+}
+} // namespace
+
+render_queue::render_queue(unsigned batch_size, unsigned jobs)
+    : batch_size_{batch_size}
+    , executor_{jobs}
+{
+}
+
+render_queue::~render_queue() { wait(); }
+
+void render_queue::add(
+    generator_type_t generator_type, const config::diagram &diagram)
+{
+    if (generator_type == generator_type_t::json)
+        return;
+
+    const auto command_template =
+        generators::command_template(generator_type, diagram);
+
+    if (command_template.empty())
+        throw std::runtime_error(
+            fmt::format("No render command template provided for {} diagrams",
+                to_string(diagram.type())));
+
+    std::lock_guard<std::mutex> l{mutex_};
+
+    // Templates which cannot be expanded for multiple diagrams, e.g.
+    // `mmdc -i {}.mmd -o {}.svg` or `plantuml "out dir/{}.puml"`, are
+    // rendered one diagram at a time
+    if (batch_size_ <= 1 ||
+        !util::expand_command_template(
+            command_template, {diagram.name, diagram.name})) {
+        schedule(command_template, {diagram.name});
+        return;
+    }
+
+    auto &batch = pending_[command_template];
+    batch.emplace_back(diagram.name);
+
+    if (batch.size() >= batch_size_) {
+        schedule(command_template, std::move(batch));
+        pending_.erase(command_template);
+    }
+}
+
+unsigned render_queue::wait()
+{
+    std::vector<std::future<void>> renders;
+    {
+        std::lock_guard<std::mutex> l{mutex_};
+
+        for (auto &[command_template, batch] : pending_) {
+            schedule(command_template, std::move(batch));
+        }
+        pending_.clear();
+
+        std::swap(renders, renders_);
+    }
+
+    for (auto &render : renders) {
+        render.get();
+    }
+
+    return failed_;
+}
+
+std::chrono::nanoseconds render_queue::commands_time() const
+{
+    return std::chrono::nanoseconds{commands_time_ns_.load()};
+}
+
+std::optional<std::filesystem::path> render_queue::rendered_path(
+    generator_type_t generator_type, const config::diagram &diagram)
+{
+    const auto arguments =
+        util::split_command_line(command_template(generator_type, diagram));
+
+    const auto diagram_file_extension =
+        generator_type == generator_type_t::plantuml ? ".puml" : ".mmd";
+
+    std::optional<std::filesystem::path> diagram_file;
+    std::string plantuml_format{"png"};
+
+    for (const auto &argument : arguments) {
+        if (argument.find("{}") == std::string::npos) {
+            if (generator_type != generator_type_t::plantuml)
+                continue;
+
+            // PlantUML output directory is relative to the diagram file
+            if (argument == "-o" || argument == "-output")
+                return {};
+
+            if (util::starts_with(argument, std::string{"-t"}) &&
+                argument.size() > 2)
+                plantuml_format = argument.substr(2);
+
+            continue;
+        }
+
+        auto expanded = argument;
+        util::replace_all(expanded, "{}", diagram.name);
+        std::filesystem::path path{expanded};
+
+        if (!util::ends_with(argument, std::string{diagram_file_extension}))
+            return path;
+
+        diagram_file = std::move(path);
+    }
+
+    if (generator_type != generator_type_t::plantuml || !diagram_file)
+        return {};
+
+    return diagram_file->replace_extension(plantuml_format);
+}
+
+void render_queue::schedule(
+    const std::string &command_template, std::vector<std::string> names)
+{
+    auto command =
+        util::expand_command_template(command_template, names).value();
+
+    renders_.emplace_back(executor_.add(
+        [this, command = std::move(command), names = std::move(names)]() {
+            LOG_INFO("Rendering diagrams {} using '{}'", fmt::join(names, ", "),
+                command);
+
+            const auto start = std::chrono::steady_clock::now();
+            util::trace_scope trace{"render", command};
+
+            try {
+                util::check_process_output(command);
+            }
+            catch (const std::exception &e) {
+                failed_ += static_cast<unsigned>(names.size());
+
+                LOG_ERROR("ERROR: Failed to render diagrams {}: {}",
+                    fmt::join(names, ", "), e.what());
+            }
+
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            commands_time_ns_ +=
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count();
+        }));
+}
+
+} // namespace clanguml::common::generators
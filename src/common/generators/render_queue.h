@@ -0,0 +1,119 @@
+/**
+ * @file src/common/generators/render_queue.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "common/model/enums.h"
+#include "config/config.h"
+#include "util/thread_pool_executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Queue of external commands rendering generated diagrams
+ *
+ * Render commands are executed asynchronously on a separate thread pool,
+ * so that diagram generation does not wait for external tools. If the
+ * batch size is larger than 1, diagrams sharing the same render command
+ * template are collected and rendered with a single command invocation
+ * (e.g. `plantuml -tsvg a.puml b.puml`), provided that the template
+ * contains exactly one `{}` placeholder.
+ */
+class render_queue {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param batch_size Maximum number of diagrams rendered by one command
+     * @param jobs Maximum number of commands running in parallel
+     *             (0 = hardware concurrency)
+     */
+    render_queue(unsigned batch_size, unsigned jobs);
+
+    render_queue(const render_queue &) = delete;
+    render_queue(render_queue &&) = delete;
+    render_queue &operator=(const render_queue &) = delete;
+    render_queue &operator=(render_queue &&) = delete;
+
+    ~render_queue();
+
+    /**
+     * @brief Schedule rendering of diagram generated using specific generator
+     *
+     * Diagrams generated in formats without a render command (e.g. JSON)
+     * are ignored.
+     *
+     * @param generator_type Type of generator used for the diagram
+     * @param diagram Diagram configuration
+     * @throws std::runtime_error If the diagram has no render command
+     */
+    void add(generator_type_t generator_type, const config::diagram &diagram);
+
+    /**
+     * @brief Render all remaining diagrams and wait for all commands
+     *
+     * @return Number of diagrams which failed to render
+     */
+    unsigned wait();
+
+    /**
+     * @brief Total execution time of all finished render commands
+     *
+     * @return Sum of render command durations
+     */
+    std::chrono::nanoseconds commands_time() const;
+
+    /**
+     * @brief Get path of the image rendered from a diagram
+     *
+     * The path is derived from the render command template, either from
+     * an argument other than the diagram file containing the `{}`
+     * placeholder (e.g. `mmdc -i {}.mmd -o {}.svg`), or from the diagram
+     * file and the PlantUML output format (e.g. `plantuml -tsvg {}.puml`).
+     *
+     * @param generator_type Type of generator used for the diagram
+     * @param diagram Diagram configuration
+     * @return Path of the rendered image, or empty if the diagram is not
+     *         rendered or the path cannot be determined from the command
+     */
+    static std::optional<std::filesystem::path> rendered_path(
+        generator_type_t generator_type, const config::diagram &diagram);
+
+private:
+    void schedule(
+        const std::string &command_template, std::vector<std::string> names);
+
+    unsigned batch_size_;
+    std::map<std::string, std::vector<std::string>> pending_;
+    std::vector<std::future<void>> renders_;
+    std::atomic_uint failed_{0};
+    std::atomic<std::int64_t> commands_time_ns_{0};
+    std::mutex mutex_;
+    util::thread_pool_executor executor_;
+};
+
+} // namespace clanguml::common::generators
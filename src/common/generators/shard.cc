@@ -0,0 +1,325 @@
+/**
+ * @file src/common/generators/shard.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shard.h"
+
+#include "class_diagram/generators/json/partial_model.h"
+#include "common/model/diagram_filter.h"
+#include "include_diagram/generators/json/partial_model.h"
+#include "package_diagram/generators/json/partial_model.h"
+#include "sequence_diagram/generators/json/partial_model.h"
+#include "util/util.h"
+#include "version.h"
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+namespace clanguml::common::generators {
+
+namespace {
+unsigned int find_shard_count(
+    const std::string &output_directory, const std::string &diagram_name)
+{
+    const auto prefix = fmt::format("{}.shard-", diagram_name);
+
+    std::set<unsigned long> counts;
+    std::error_code ec;
+    for (const auto &entry :
+        std::filesystem::directory_iterator{output_directory, ec}) {
+        const auto file_name = entry.path().filename().string();
+        if (!util::starts_with(file_name, prefix) ||
+            !util::ends_with(file_name, std::string{".json"}))
+            continue;
+
+        const auto of = file_name.rfind("-of-");
+        if (of == std::string::npos)
+            continue;
+
+        try {
+            counts.emplace(std::stoul(file_name.substr(of + 4)));
+        }
+        catch (const std::exception &) {
+            continue;
+        }
+    }
+
+    if (counts.empty())
+        throw std::runtime_error(fmt::format(
+            "No partial models of diagram {} found in {}", diagram_name,
+            output_directory));
+
+    if (counts.size() > 1)
+        throw std::runtime_error(fmt::format(
+            "Partial models of diagram {} with different shard counts ({}) "
+            "found in {}",
+            diagram_name, fmt::join(counts, ", "), output_directory));
+
+    return static_cast<unsigned int>(*counts.begin());
+}
+
+nlohmann::json export_model(const model::diagram &partial_model)
+{
+    switch (partial_model.type()) {
+    case model::diagram_t::kClass:
+        return class_diagram::generators::json::export_partial_model(
+            dynamic_cast<const class_diagram::model::diagram &>(
+                partial_model));
+    case model::diagram_t::kSequence:
+        return sequence_diagram::generators::json::export_partial_model(
+            dynamic_cast<const sequence_diagram::model::diagram &>(
+                partial_model));
+    case model::diagram_t::kPackage:
+        return package_diagram::generators::json::export_partial_model(
+            dynamic_cast<const package_diagram::model::diagram &>(
+                partial_model));
+    case model::diagram_t::kInclude:
+        return include_diagram::generators::json::export_partial_model(
+            dynamic_cast<const include_diagram::model::diagram &>(
+                partial_model));
+    }
+
+    return {};
+}
+
+template <typename DiagramT>
+std::unique_ptr<DiagramT> make_diagram(clanguml::config::diagram &diagram)
+{
+    auto result = std::make_unique<DiagramT>();
+    result->set_name(diagram.name);
+    result->set_filter(
+        std::make_unique<model::diagram_filter>(*result, diagram));
+
+    return result;
+}
+
+std::unique_ptr<model::diagram> import_models(
+    clanguml::config::diagram &diagram,
+    const std::vector<nlohmann::json> &partial_models)
+{
+    switch (diagram.type()) {
+    case model::diagram_t::kClass: {
+        auto result = make_diagram<class_diagram::model::diagram>(diagram);
+        class_diagram::generators::json::import_partial_models(partial_models,
+            dynamic_cast<const clanguml::config::class_diagram &>(diagram),
+            *result);
+        return result;
+    }
+    case model::diagram_t::kSequence: {
+        auto result = make_diagram<sequence_diagram::model::diagram>(diagram);
+        sequence_diagram::generators::json::import_partial_models(
+            partial_models, *result);
+        return result;
+    }
+    case model::diagram_t::kPackage: {
+        auto result = make_diagram<package_diagram::model::diagram>(diagram);
+        package_diagram::generators::json::import_partial_models(
+            partial_models, *result);
+        return result;
+    }
+    case model::diagram_t::kInclude: {
+        auto result = make_diagram<include_diagram::model::diagram>(diagram);
+        include_diagram::generators::json::import_partial_models(
+            partial_models, *result);
+        return result;
+    }
+    }
+
+    return {};
+}
+
+/**
+ * Translation unit paths are made relative to the compilation database
+ * directory, so that shards running in checkouts with different root
+ * directories assign translation units in the same way.
+ */
+std::string relative_translation_unit(
+    const std::string &tu, const std::filesystem::path &root)
+{
+    const auto relative = std::filesystem::path{tu}.lexically_normal()
+                              .lexically_relative(root.lexically_normal());
+
+    if (relative.empty())
+        return std::filesystem::path{tu}.generic_string();
+
+    return relative.generic_string();
+}
+
+void check_translation_units_coverage(const std::string &diagram_name,
+    const std::vector<nlohmann::json> &shards)
+{
+    std::map<std::string, unsigned int> covered;
+    std::set<std::size_t> counts;
+    for (const auto &j : shards) {
+        const auto index = j.at("shard").at("index").get<unsigned int>();
+
+        counts.emplace(j.at("translation_unit_count").get<std::size_t>());
+
+        for (const auto &tu : j.at("translation_units")) {
+            const auto [it, inserted] =
+                covered.emplace(tu.get<std::string>(), index);
+            if (!inserted)
+                throw std::runtime_error(fmt::format(
+                    "Translation unit {} of diagram {} was processed by "
+                    "shards {} and {}",
+                    it->first, diagram_name, it->second, index));
+        }
+    }
+
+    if (counts.size() > 1)
+        throw std::runtime_error(fmt::format(
+            "Shards of diagram {} have different numbers of translation "
+            "units ({})",
+            diagram_name, fmt::join(counts, ", ")));
+
+    if (!counts.empty() && covered.size() != *counts.begin())
+        throw std::runtime_error(fmt::format(
+            "Shards of diagram {} processed {} out of {} translation units",
+            diagram_name, covered.size(), *counts.begin()));
+}
+} // namespace
+
+std::vector<std::string> shard_translation_units(
+    const std::vector<std::string> &translation_units,
+    const std::filesystem::path &compilation_database_dir, unsigned int index,
+    unsigned int count)
+{
+    std::vector<std::string> result;
+    std::copy_if(translation_units.begin(), translation_units.end(),
+        std::back_inserter(result), [&](const auto &tu) {
+            return util::stable_hash(relative_translation_unit(
+                       tu, compilation_database_dir)) %
+                count ==
+                index - 1;
+        });
+
+    return result;
+}
+
+std::filesystem::path shard_path(const std::string &output_directory,
+    const std::string &diagram_name, unsigned int index, unsigned int count)
+{
+    return std::filesystem::path{output_directory} /
+        fmt::format("{}.shard-{}-of-{}.json", diagram_name, index, count);
+}
+
+void export_partial_model(const std::filesystem::path &path,
+    const clanguml::config::diagram &diagram,
+    const model::diagram *partial_model,
+    const std::vector<std::string> &translation_units,
+    const std::filesystem::path &compilation_database_dir, unsigned int index,
+    unsigned int count)
+{
+    auto shard_units = nlohmann::json::array();
+    for (const auto &tu : shard_translation_units(
+             translation_units, compilation_database_dir, index, count))
+        shard_units.push_back(
+            relative_translation_unit(tu, compilation_database_dir));
+
+    nlohmann::json j;
+    j["version"] = clanguml::version::CLANG_UML_VERSION;
+    j["diagram"] = diagram.name;
+    j["diagram_type"] = to_string(diagram.type());
+    j["shard"] = {{"index", index}, {"count", count}};
+    j["translation_unit_count"] = translation_units.size();
+    j["translation_units"] = std::move(shard_units);
+    j["model"] = partial_model == nullptr ? nlohmann::json{}
+                                          : export_model(*partial_model);
+
+    std::ofstream ofs{path};
+    // Diagram comments are not guaranteed to be valid UTF-8
+    ofs << j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+
+    if (!ofs)
+        throw std::runtime_error(
+            fmt::format("Failed to write partial model {}", path.string()));
+
+    LOG_INFO("Written partial model of diagram {} to {}", diagram.name,
+        path.string());
+}
+
+std::unique_ptr<model::diagram> merge_partial_models(
+    clanguml::config::diagram &diagram, const std::string &output_directory)
+{
+    const auto count = find_shard_count(output_directory, diagram.name);
+
+    std::vector<nlohmann::json> shards;
+    for (auto index = 1U; index <= count; index++) {
+        const auto path =
+            shard_path(output_directory, diagram.name, index, count);
+
+        std::ifstream ifs{path};
+        if (!ifs)
+            throw std::runtime_error(fmt::format(
+                "Missing shard {}/{} of diagram {}: {}", index, count,
+                diagram.name, path.string()));
+
+        try {
+            auto j = nlohmann::json::parse(ifs);
+
+            if (j.at("version").get<std::string>() !=
+                clanguml::version::CLANG_UML_VERSION)
+                throw std::runtime_error(fmt::format(
+                    "Partial model {} was generated by clang-uml {}",
+                    path.string(), j.at("version").get<std::string>()));
+
+            if (j.at("diagram_type").get<std::string>() !=
+                to_string(diagram.type()))
+                throw std::runtime_error(fmt::format(
+                    "Partial model {} is a model of a {} diagram",
+                    path.string(), j.at("diagram_type").get<std::string>()));
+
+            shards.emplace_back(std::move(j));
+        }
+        catch (const nlohmann::json::exception &e) {
+            throw std::runtime_error(fmt::format(
+                "Invalid partial model {}: {}", path.string(), e.what()));
+        }
+    }
+
+    std::unique_ptr<model::diagram> result;
+    try {
+        check_translation_units_coverage(diagram.name, shards);
+
+        // Shards, which did not get any translation units, have no model
+        std::vector<nlohmann::json> partial_models;
+        for (auto &j : shards) {
+            if (!j.at("model").is_null())
+                partial_models.emplace_back(std::move(j.at("model")));
+        }
+
+        result = import_models(diagram, partial_models);
+    }
+    catch (const nlohmann::json::exception &e) {
+        throw std::runtime_error(fmt::format(
+            "Invalid partial models of diagram {}: {}", diagram.name,
+            e.what()));
+    }
+
+    LOG_INFO("Merged {} shards of diagram {}", count, diagram.name);
+
+    result->set_complete(true);
+    result->finalize();
+
+    return result;
+}
+
+} // namespace clanguml::common::generators
@@ -0,0 +1,102 @@
+/**
+ * @file src/common/generators/shard.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "common/model/diagram.h"
+#include "config/config.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clanguml::common::generators {
+
+/**
+ * @brief Select translation units processed by a single shard
+ *
+ * Translation units are assigned to shards based on a stable hash of their
+ * path relative to the compilation database directory, so that each shard
+ * gets the same subset regardless of the order of the compilation database
+ * or the directory, in which the project is checked out.
+ *
+ * @param translation_units List of translation units for the diagram
+ * @param compilation_database_dir Absolute path of the compilation database
+ *                                 directory
+ * @param index Index of the shard, starting from 1
+ * @param count Total number of shards
+ * @return Translation units processed by the shard
+ */
+std::vector<std::string> shard_translation_units(
+    const std::vector<std::string> &translation_units,
+    const std::filesystem::path &compilation_database_dir, unsigned int index,
+    unsigned int count);
+
+/**
+ * @brief Get path of the partial model file of a diagram shard
+ *
+ * @param output_directory Output directory
+ * @param diagram_name Name of the diagram
+ * @param index Index of the shard, starting from 1
+ * @param count Total number of shards
+ * @return Path to the partial model file
+ */
+std::filesystem::path shard_path(const std::string &output_directory,
+    const std::string &diagram_name, unsigned int index, unsigned int count);
+
+/**
+ * @brief Write partial diagram model generated by a single shard
+ *
+ * Besides the model, the file records the translation units assigned to
+ * the shard and the total number of translation units of the diagram, so
+ * that the merge step can check that each was processed exactly once.
+ *
+ * @param path Path to the partial model file
+ * @param diagram Effective diagram configuration
+ * @param partial_model Partial diagram model, or nullptr if the shard did
+ *                      not get any translation units
+ * @param translation_units List of all translation units for the diagram
+ * @param compilation_database_dir Absolute path of the compilation database
+ *                                 directory
+ * @param index Index of the shard, starting from 1
+ * @param count Total number of shards
+ */
+void export_partial_model(const std::filesystem::path &path,
+    const clanguml::config::diagram &diagram,
+    const model::diagram *partial_model,
+    const std::vector<std::string> &translation_units,
+    const std::filesystem::path &compilation_database_dir, unsigned int index,
+    unsigned int count);
+
+/**
+ * @brief Combine partial models of all shards of a diagram into a single
+ *        diagram model
+ *
+ * Throws `std::runtime_error` if any of the shards is missing or was
+ * generated by a different version of clang-uml or for a different diagram
+ * type, or if the translation units of the diagram were not processed by
+ * exactly one shard each.
+ *
+ * @param diagram Effective diagram configuration
+ * @param output_directory Directory containing the partial model files
+ * @return Complete and finalized diagram model
+ */
+std::unique_ptr<model::diagram> merge_partial_models(
+    clanguml::config::diagram &diagram, const std::string &output_directory);
+
+} // namespace clanguml::common::generators
@@ -78,6 +78,14 @@ bool diagram::should_include(const namespace_ &ns) const
     return filter_->should_include(ns);
 }
 
+bool diagram::excludes_namespace_subtree(const namespace_ &ns) const
+{
+    if (filter_.get() == nullptr)
+        return false;
+
+    return filter_->excludes_namespace_subtree(ns);
+}
+
 bool diagram::should_include(relationship r) const
 {
     return should_include(r.type());
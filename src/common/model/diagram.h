@@ -152,6 +152,15 @@ public:
     // Disallow std::string overload
     bool should_include(const std::string &s) const = delete;
 
+    /**
+     * @brief Check if diagram filters exclude all elements in a namespace
+     *
+     * @param ns Namespace
+     * @return True, if no element in namespace or its nested namespaces
+     *         can be included in the diagram
+     */
+    bool excludes_namespace_subtree(const namespace_ &ns) const;
+
     virtual bool has_element(const eid_t /*id*/) const { return false; }
 
     virtual bool should_include(
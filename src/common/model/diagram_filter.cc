@@ -123,6 +123,11 @@ tvl::value_t filter_visitor::match(
     return {};
 }
 
+bool filter_visitor::excludes_namespace_subtree(const namespace_ & /*ns*/) const
+{
+    return false;
+}
+
 tvl::value_t filter_visitor::match(
     const diagram & /*d*/, const common::model::source_location & /*f*/) const
 {
@@ -216,6 +221,40 @@ tvl::value_t namespace_filter::match(
         });
 }
 
+bool namespace_filter::excludes_namespace_subtree(const namespace_ &ns) const
+{
+    if (ns.is_empty())
+        return false;
+
+    const auto is_namespace_pattern = [](const auto &nsit) {
+        return std::holds_alternative<namespace_>(nsit.value());
+    };
+
+    // Exclusive namespace pattern matches all namespaces nested in it
+    if (is_exclusive()) {
+        return std::any_of(namespaces_.begin(), namespaces_.end(),
+            [&ns, &is_namespace_pattern](const auto &nsit) {
+                return is_namespace_pattern(nsit) &&
+                    ns.starts_with(std::get<namespace_>(nsit.value()));
+            });
+    }
+
+    // Inclusive namespace patterns cannot match any namespace nested in `ns`
+    // if they are neither a parent nor a child of `ns`
+    if (namespaces_.empty())
+        return false;
+
+    return std::all_of(namespaces_.begin(), namespaces_.end(),
+        [&ns, &is_namespace_pattern](const auto &nsit) {
+            if (!is_namespace_pattern(nsit))
+                return false;
+
+            const auto &ns_pattern = std::get<namespace_>(nsit.value());
+
+            return !ns.starts_with(ns_pattern) && !ns_pattern.starts_with(ns);
+        });
+}
+
 tvl::value_t namespace_filter::match(const diagram &d, const element &e) const
 {
     if (d.type() != diagram_t::kPackage &&
@@ -766,16 +805,15 @@ void context_filter::find_elements_inheritance_relationship(const diagram &d,
 
 void context_filter::initialize(const diagram &d) const
 {
-    if (initialized_)
-        return;
-
-    initialized_ = true;
+    std::call_once(initialized_, [this, &d]() {
+        util::trace_scope trace{"filter", "context_filter::initialize"};
 
-    // Prepare effective_contexts_
-    for (auto i = 0U; i < context_.size(); i++) {
-        effective_contexts_.push_back({}); // NOLINT
-        initialize_effective_context(d, i);
-    }
+        // Prepare effective_contexts_
+        for (auto i = 0U; i < context_.size(); i++) {
+            effective_contexts_.push_back({}); // NOLINT
+            initialize_effective_context(d, i);
+        }
+    });
 }
 
 tvl::value_t context_filter::match(const diagram &d, const element &e) const
@@ -960,6 +998,16 @@ bool diagram_filter::should_include(
     return false;
 }
 
+bool diagram_filter::excludes_namespace_subtree(const namespace_ &ns) const
+{
+    const auto excludes = [&ns](const auto &f) {
+        return f->excludes_namespace_subtree(ns);
+    };
+
+    return std::any_of(exclusive_.begin(), exclusive_.end(), excludes) ||
+        std::any_of(inclusive_.begin(), inclusive_.end(), excludes);
+}
+
 void diagram_filter::init_filters(const config::diagram &c)
 {
     using specializations_filter_t =
@@ -31,8 +31,10 @@
 #include "sequence_diagram/model/participant.h"
 #include "source_file.h"
 #include "tvl.h"
+#include "util/trace.h"
 
 #include <filesystem>
+#include <mutex>
 #include <utility>
 
 namespace clanguml::common::model {
@@ -108,6 +110,14 @@ public:
     virtual tvl::value_t match(
         const diagram &d, const sequence_diagram::model::participant &p) const;
 
+    /**
+     * @brief Check if filter excludes namespace and all its nested namespaces
+     *
+     * @param ns Namespace
+     * @return True, if this filter does not match any element in namespace
+     */
+    virtual bool excludes_namespace_subtree(const namespace_ &ns) const;
+
     bool is_inclusive() const;
     bool is_exclusive() const;
 
@@ -150,6 +160,8 @@ struct namespace_filter : public filter_visitor {
 
     tvl::value_t match(const diagram &d, const element &e) const override;
 
+    bool excludes_namespace_subtree(const namespace_ &ns) const override;
+
 private:
     std::vector<common::namespace_or_regex> namespaces_;
 };
@@ -373,9 +385,16 @@ private:
 
     void init(const DiagramT &cd) const
     {
-        if (initialized_)
-            return;
+        // Filters are shared by all generators of a diagram, which can run
+        // in parallel, so the matching elements must be computed only once
+        std::call_once(initialized_, [this, &cd]() {
+            util::trace_scope trace{"filter", "edge_traversal_filter::init"};
+            init_matching_elements(cd);
+        });
+    }
 
+    void init_matching_elements(const DiagramT &cd) const
+    {
         // First get all elements specified in the filter configuration
         // which will serve as starting points for the search
         // of matching elements
@@ -419,13 +438,11 @@ private:
             (cd.type() == common::model::diagram_t::kPackage)) {
             add_parents(cd);
         }
-
-        initialized_ = true;
     }
 
     std::vector<ConfigEntryT> roots_;
     relationship_t relationship_;
-    mutable bool initialized_{false};
+    mutable std::once_flag initialized_;
     mutable clanguml::common::reference_set<ElementT> matching_elements_;
     bool forward_;
 };
@@ -546,7 +563,7 @@ private:
     mutable std::vector<std::set<eid_t>> effective_contexts_;
 
     /*! Flag to mark whether the filter context has been computed */
-    mutable bool initialized_{false};
+    mutable std::once_flag initialized_;
 };
 
 /**
@@ -638,6 +655,18 @@ public:
      */
     bool should_include(const namespace_ &ns, const std::string &name) const;
 
+    /**
+     * @brief Check if namespace filters exclude entire namespace subtree
+     *
+     * This is used to skip traversal of namespaces, such as `std`, whose
+     * declarations cannot be included in the diagram. Namespaces matched
+     * by regular expressions are never considered as excluded.
+     *
+     * @param ns Namespace
+     * @return True, if namespace and all nested namespaces are excluded
+     */
+    bool excludes_namespace_subtree(const namespace_ &ns) const;
+
     /**
      * Generic `should_include` overload for various diagram elements.
      *
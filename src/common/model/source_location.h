@@ -17,6 +17,8 @@
  */
 #pragma once
 
+#include "util/interned_string.h"
+
 #include <string>
 #include <utility>
 
@@ -31,8 +33,8 @@ class source_location {
 public:
     source_location() = default;
 
-    source_location(std::string f, unsigned int l)
-        : file_{std::move(f)}
+    source_location(const std::string &f, unsigned int l)
+        : file_{f}
         , line_{l}
     {
     }
@@ -42,7 +44,7 @@ public:
      *
      * @return Absolute file path.
      */
-    const std::string &file() const { return file_; }
+    const std::string &file() const { return file_.str(); }
 
     /**
      * Set absolute file path.
@@ -56,7 +58,7 @@ public:
      *
      * @return Relative file path.
      */
-    const std::string &file_relative() const { return file_relative_; }
+    const std::string &file_relative() const { return file_relative_.str(); }
 
     /**
      * Set relative file path.
@@ -70,7 +72,10 @@ public:
      *
      * @return Path to the translation unit.
      */
-    const std::string &translation_unit() const { return translation_unit_; }
+    const std::string &translation_unit() const
+    {
+        return translation_unit_.str();
+    }
 
     /**
      * Set the path to translation unit, from which this source location was
@@ -130,9 +135,10 @@ public:
     void set_location_id(unsigned int h) { hash_ = h; }
 
 private:
-    std::string file_;
-    std::string file_relative_;
-    std::string translation_unit_;
+    // File paths are shared by many elements, so they are interned
+    util::interned_string file_;
+    util::interned_string file_relative_;
+    util::interned_string translation_unit_;
     unsigned int line_{0};
     unsigned int column_{0};
     unsigned int hash_{0};
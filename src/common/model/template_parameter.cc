@@ -171,9 +171,9 @@ std::optional<std::string> template_parameter::type() const
         return {};
 
     if (is_variadic_)
-        return type_.value() + "...";
+        return type_->str() + "...";
 
-    return type_;
+    return type_->str();
 }
 
 void template_parameter::set_name(const std::string &name)
@@ -197,14 +197,13 @@ std::optional<std::string> template_parameter::name() const
     if (!name_)
         return {};
 
-    if (kind_ == template_parameter_kind_t::template_type &&
-        name_.has_value() && name_.value().empty())
+    if (kind_ == template_parameter_kind_t::template_type && name_->empty())
         return "typename";
 
     if (is_variadic_ && (kind_ != template_parameter_kind_t::non_type_template))
-        return name_.value() + "...";
+        return name_->str() + "...";
 
-    return name_;
+    return name_->str();
 }
 
 void template_parameter::set_default_value(const std::string &value)
@@ -214,9 +213,12 @@ void template_parameter::set_default_value(const std::string &value)
     default_value_ = value;
 }
 
-const std::optional<std::string> &template_parameter::default_value() const
+std::optional<std::string> template_parameter::default_value() const
 {
-    return default_value_;
+    if (!default_value_)
+        return {};
+
+    return default_value_->str();
 }
 
 void template_parameter::is_variadic(bool is_variadic) noexcept
@@ -345,12 +347,16 @@ bool operator==(const template_parameter &l, const template_parameter &r)
     if (l.is_template_parameter()) {
         // If this is a template parameter (e.g. 'typename T' or 'typename U'
         // we don't actually care what it is called
-        res = (l.is_variadic() == r.is_variadic()) &&
-            (l.default_value() == r.default_value());
+        res = (l.is_variadic_ == r.is_variadic_) &&
+            (l.default_value_ == r.default_value_);
+    }
+    else {
+        // Interned strings are compared directly, as name() and type() would
+        // build temporary strings with the variadic suffix
+        res = (l.name_ == r.name_) && (l.type_ == r.type_) &&
+            (l.is_variadic_ == r.is_variadic_) &&
+            (l.default_value_ == r.default_value_);
     }
-    else
-        res = (l.name() == r.name()) && (l.type() == r.type()) &&
-            (l.default_value() == r.default_value());
 
     return res && (l.template_params_ == r.template_params_);
 }
@@ -587,12 +593,15 @@ void template_parameter::is_template_template_parameter(
 
 void template_parameter::set_concept_constraint(std::string constraint)
 {
-    concept_constraint_ = std::move(constraint);
+    concept_constraint_ = constraint;
 }
 
-const std::optional<std::string> &template_parameter::concept_constraint() const
+std::optional<std::string> template_parameter::concept_constraint() const
 {
-    return concept_constraint_;
+    if (!concept_constraint_)
+        return {};
+
+    return concept_constraint_->str();
 }
 
 bool template_parameter::is_association() const
@@ -641,15 +650,15 @@ bool template_parameter::is_array() const { return is_array_; }
 
 void template_parameter::push_context(const context &q)
 {
-    context_.push_front(q);
+    context_.insert(context_.begin(), q);
 }
 
-const std::deque<context> &template_parameter::deduced_context() const
+const std::vector<context> &template_parameter::deduced_context() const
 {
     return context_;
 }
 
-void template_parameter::deduced_context(std::deque<context> c)
+void template_parameter::deduced_context(std::vector<context> c)
 {
     context_ = std::move(c);
 }
@@ -20,8 +20,8 @@
 #include "common/model/enums.h"
 #include "common/model/namespace.h"
 #include "common/types.h"
+#include "util/interned_string.h"
 
-#include <deque>
 #include <optional>
 #include <set>
 #include <string>
@@ -203,7 +203,7 @@ public:
      *
      * @return Default value
      */
-    const std::optional<std::string> &default_value() const;
+    std::optional<std::string> default_value() const;
 
     /**
      * Set template parameters variadic status.
@@ -409,7 +409,7 @@ public:
      *
      * @return Optional concept constraint name
      */
-    const std::optional<std::string> &concept_constraint() const;
+    std::optional<std::string> concept_constraint() const;
 
     /**
      * Get the kind of the template parameter or argument
@@ -436,14 +436,14 @@ public:
      *
      * @return Deduced context of this template parameter
      */
-    const std::deque<context> &deduced_context() const;
+    const std::vector<context> &deduced_context() const;
 
     /**
      * Set the deduced context for the template parameter
      *
      * @param c Deduced context.
      */
-    void deduced_context(std::deque<context> c);
+    void deduced_context(std::vector<context> c);
 
     /**
      * Set, whether the parameter is an ellipsis (...)
@@ -481,18 +481,10 @@ private:
 
     std::string deduced_context_str() const;
 
-    template_parameter_kind_t kind_{template_parameter_kind_t::template_type};
-
-    /*! Represents the type of non-type template parameters e.g. 'int' or type
-     * of template arguments
-     */
-    std::optional<std::string> type_;
+    // Members are ordered to minimize padding, as template heavy code can
+    // produce very large numbers of template parameters
 
-    /*! The name of the parameter (e.g. 'T' or 'N') */
-    std::optional<std::string> name_;
-
-    /*! Default value of the template parameter */
-    std::optional<std::string> default_value_;
+    template_parameter_kind_t kind_{template_parameter_kind_t::template_type};
 
     /*! Whether the template parameter is a regular template parameter. When
      * false, it is a non-type template parameter
@@ -522,13 +514,29 @@ private:
     /*! Is template argument an array */
     bool is_array_{false};
 
-    /*! Stores the template parameter/argument deduction context e.g. const& */
-    std::deque<context> context_;
+    bool is_unexposed_{false};
+
+    /*! Represents the type of non-type template parameters e.g. 'int' or type
+     * of template arguments
+     */
+    std::optional<util::interned_string> type_;
+
+    /*! The name of the parameter (e.g. 'T' or 'N') */
+    std::optional<util::interned_string> name_;
+
+    /*! Default value of the template parameter */
+    std::optional<util::interned_string> default_value_;
 
     /*! Stores optional fully qualified name of constraint for this template
      * parameter
      */
-    std::optional<std::string> concept_constraint_;
+    std::optional<util::interned_string> concept_constraint_;
+
+    /*! Stores the template parameter/argument deduction context e.g. const&.
+     * Usually empty or very short, so unlike std::deque, it does not allocate
+     * unless needed.
+     */
+    std::vector<context> context_;
 
     /*! Nested template parameters. If this is a function template, the first
      * element is the return type
@@ -536,8 +544,6 @@ private:
     std::vector<template_parameter> template_params_;
 
     std::optional<eid_t> id_;
-
-    bool is_unexposed_{false};
 };
 
 /**
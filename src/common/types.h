@@ -343,6 +343,15 @@ struct path_or_regex : public or_regex<std::filesystem::path> { };
 
 } // namespace clanguml::common
 
+namespace std {
+template <> struct hash<clanguml::common::eid_t> {
+    std::size_t operator()(const clanguml::common::eid_t &key) const
+    {
+        return std::hash<clanguml::common::eid_t::type>{}(key.value());
+    }
+};
+} // namespace std
+
 template <> class fmt::formatter<clanguml::common::eid_t> {
 public:
     constexpr auto parse(format_parse_context &ctx) { return ctx.begin(); }
@@ -32,10 +32,11 @@ std::optional<eid_t> ast_id_mapper::get_global_id(eid_t ast_id)
     if (ast_id.is_global())
         return {};
 
-    if (id_map_.count(ast_id.ast_local_value()) == 0)
+    const auto it = id_map_.find(ast_id.ast_local_value());
+    if (it == id_map_.end())
         return {};
 
-    return id_map_.at(ast_id.ast_local_value());
+    return it->second;
 }
 
 } // namespace clanguml::common::visitor
\ No newline at end of file
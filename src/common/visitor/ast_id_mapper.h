@@ -18,9 +18,9 @@
 #pragma once
 
 #include "common/model/diagram_element.h"
+#include "util/flat_hash_map.h"
 
 #include <cstdint>
-#include <map>
 
 namespace clanguml::common::visitor {
 
@@ -61,7 +61,7 @@ public:
     std::optional<eid_t> get_global_id(eid_t ast_id);
 
 private:
-    std::map</* Clang AST translation unit local id */ int64_t,
+    util::flat_hash_map</* Clang AST translation unit local id */ int64_t,
         /* clang-uml global id */ eid_t>
         id_map_;
 };
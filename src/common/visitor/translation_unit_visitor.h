@@ -39,6 +39,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace clanguml::common::visitor {
 
@@ -89,6 +90,26 @@ public:
         translation_unit_path_.make_preferred();
     }
 
+    /**
+     * @brief Enable or disable parsing of declaration comments
+     *
+     * If disabled, only comments containing clang-uml directives are
+     * parsed, and element comments are not set.
+     *
+     * @param parse_comments Whether comments should be parsed
+     */
+    void set_parse_comments(bool parse_comments)
+    {
+        parse_comments_ = parse_comments;
+    }
+
+    /**
+     * @brief Whether element comments should be parsed
+     *
+     * @return True, if element comments are used by the diagram
+     */
+    bool parse_comments() const { return parse_comments_; }
+
     /**
      * @brief Return relative path to current translation unit
      * @return Current translation unit path
@@ -160,21 +181,36 @@ public:
     void set_source_location(const clang::SourceLocation &location,
         clanguml::common::model::source_location &element)
     {
-        namespace fs = std::filesystem;
-
         std::string file;
         unsigned line{};
         unsigned column{};
+        const source_file_paths *paths{nullptr};
 
         if (location.isValid()) {
-            file = source_manager_.getFilename(location).str();
             line = source_manager_.getSpellingLineNumber(location);
             column = source_manager_.getSpellingColumnNumber(location);
 
-            if (file.empty()) {
-                // Why do I have to do this?
-                parse_source_location(location.printToString(source_manager()),
-                    file, line, column);
+            const auto file_id =
+                source_manager_.getFileID(location).getHashValue();
+
+            if (auto it = source_file_paths_.find(file_id);
+                it != source_file_paths_.end()) {
+                paths = &it->second;
+            }
+            else {
+                file = source_manager_.getFilename(location).str();
+
+                if (file.empty()) {
+                    // Why do I have to do this?
+                    parse_source_location(
+                        location.printToString(source_manager()), file, line,
+                        column);
+                }
+                else {
+                    paths = &source_file_paths_
+                                 .emplace(file_id, resolve_source_file(file))
+                                 .first->second;
+                }
             }
         }
         else {
@@ -187,26 +223,14 @@ public:
             }
         }
 
-        // ensure the path is absolute
-        fs::path file_path{file};
-        if (!file_path.is_absolute()) {
-            file_path = fs::absolute(file_path);
-        }
-
-        file_path = fs::weakly_canonical(file_path);
-
-        file = file_path.string();
-
-        element.set_file(file);
-
-        if (util::is_relative_to(file_path, relative_to_path_)) {
-            element.set_file_relative(util::path_to_url(
-                fs::relative(element.file(), relative_to_path_).string()));
-        }
-        else {
-            element.set_file_relative("");
+        source_file_paths uncached_paths;
+        if (paths == nullptr) {
+            uncached_paths = resolve_source_file(file);
+            paths = &uncached_paths;
         }
 
+        element.set_file(paths->file);
+        element.set_file_relative(paths->file_relative);
         element.set_translation_unit(tu_path().string());
         element.set_line(line);
         element.set_column(column);
@@ -251,7 +275,8 @@ public:
     {
         assert(comment_visitor_.get() != nullptr);
 
-        comment_visitor_->visit(decl, e);
+        if (parse_comments_)
+            comment_visitor_->visit(decl, e);
 
         const auto *comment =
             decl.getASTContext().getRawCommentForDeclNoCache(&decl);
@@ -279,6 +304,13 @@ public:
         if (!inserted)
             return {};
 
+        // Unless comments are used in the diagram, only comments with
+        // clang-uml directives (`@uml{...}` or `\uml{...}`) have to be
+        // formatted and parsed
+        if (!parse_comments_ &&
+            !comment->getRawText(source_manager_).contains("uml{"))
+            return {};
+
         // Process clang-uml decorators in the comments
         // TODO: Refactor to use standard block comments processable by
         //       clang comments
@@ -305,16 +337,27 @@ public:
                 decl->getSourceRange().getBegin()))
             return false;
 
-        auto should_include_namespace = diagram().should_include(
-            common::model::namespace_{decl->getQualifiedNameAsString()});
-
-        const auto decl_file =
-            decl->getLocation().printToString(source_manager());
+        return should_include_namespace(decl) && should_include_file(decl);
+    }
 
-        const auto should_include_decl_file =
-            diagram().should_include(common::model::source_file{decl_file});
+    /**
+     * @brief Check if the diagram filters exclude entire namespace.
+     *
+     * This allows to skip traversal of declarations in namespaces, which
+     * cannot be included in the diagram. Anonymous and inline namespaces
+     * are never excluded, as their names are not always part of the
+     * qualified names of their declarations.
+     *
+     * @param ns Namespace declaration.
+     * @return True, if no declaration in the namespace can be included.
+     */
+    bool is_namespace_excluded(const clang::NamespaceDecl &ns) const
+    {
+        if (ns.isAnonymousNamespace() || ns.isInline())
+            return false;
 
-        return should_include_namespace && should_include_decl_file;
+        return diagram().excludes_namespace_subtree(
+            common::model::namespace_{ns.getQualifiedNameAsString()});
     }
 
     /**
@@ -345,6 +388,111 @@ protected:
     }
 
 private:
+    /**
+     * @brief Absolute and relative paths of a source file
+     */
+    struct source_file_paths {
+        std::string file;
+        std::string file_relative;
+    };
+
+    /**
+     * @brief Check if the diagram namespace filters include a declaration.
+     *
+     * The decision is cached for each declaration context and name, as the
+     * qualified name of a named declaration depends only on these.
+     *
+     * @param decl Clang declaration.
+     * @return True, if the declaration's namespace should be included.
+     */
+    bool should_include_namespace(const clang::NamedDecl *decl)
+    {
+        const auto decl_name = decl->getDeclName();
+
+        // Qualified names of anonymous declarations contain their location
+        if (decl_name.isEmpty()) {
+            return diagram().should_include(
+                common::model::namespace_{decl->getQualifiedNameAsString()});
+        }
+
+        const auto key =
+            std::make_pair(decl->getDeclContext(), decl_name.getAsOpaquePtr());
+
+        if (auto it = namespace_decisions_.find(key);
+            it != namespace_decisions_.end())
+            return it->second;
+
+        const auto result = diagram().should_include(
+            common::model::namespace_{decl->getQualifiedNameAsString()});
+
+        namespace_decisions_.emplace(key, result);
+
+        return result;
+    }
+
+    /**
+     * @brief Check if the diagram path filters include a declaration.
+     *
+     * The decision is cached for each file in the translation unit.
+     *
+     * @param decl Clang declaration.
+     * @return True, if the declaration's source file should be included.
+     */
+    bool should_include_file(const clang::NamedDecl *decl)
+    {
+        const auto location = decl->getLocation();
+
+        // Locations in macro expansions are printed with their spelling
+        // location, so they cannot be cached per file
+        if (!location.isFileID()) {
+            return diagram().should_include(common::model::source_file{
+                location.printToString(source_manager())});
+        }
+
+        const auto file_id =
+            source_manager().getFileID(location).getHashValue();
+
+        if (auto it = file_decisions_.find(file_id);
+            it != file_decisions_.end())
+            return it->second;
+
+        const auto result = diagram().should_include(common::model::source_file{
+            location.printToString(source_manager())});
+
+        file_decisions_.emplace(file_id, result);
+
+        return result;
+    }
+
+    /**
+     * @brief Resolve canonical absolute and relative paths of a source file
+     *
+     * @param file Source file path as reported by Clang
+     * @return Resolved source file paths
+     */
+    source_file_paths resolve_source_file(const std::string &file) const
+    {
+        namespace fs = std::filesystem;
+
+        // ensure the path is absolute
+        fs::path file_path{file};
+        if (!file_path.is_absolute()) {
+            file_path = fs::absolute(file_path);
+        }
+
+        file_path = util::cached_weakly_canonical(file_path);
+
+        source_file_paths result;
+        result.file = file_path.string();
+
+        if (util::is_relative_to(file_path, relative_to_path_)) {
+            result.file_relative = util::path_to_url(
+                fs::relative(file_path, relative_to_path_).string());
+        }
+
+        return result;
+    }
+
     // Reference to the output diagram model
     DiagramT &diagram_;
 
@@ -359,8 +507,23 @@ private:
 
     std::filesystem::path translation_unit_path_;
 
+    bool parse_comments_{true};
+
     std::set<const clang::RawComment *> processed_comments_;
 
+    // Cache of resolved source file paths for each FileID in current
+    // translation unit
+    std::unordered_map<unsigned, source_file_paths> source_file_paths_;
+
+    // Cache of namespace filter decisions for declaration names in specific
+    // declaration contexts
+    std::map<std::pair<const clang::DeclContext *, void *>, bool>
+        namespace_decisions_;
+
+    // Cache of path filter decisions for each FileID in current translation
+    // unit
+    std::unordered_map<unsigned, bool> file_decisions_;
+
     mutable common::visitor::ast_id_mapper id_mapper_;
 };
 } // namespace clanguml::common::visitor
@@ -336,6 +336,29 @@ std::vector<std::string> diagram::make_module_relative(
     return module_path;
 }
 
+bool diagram::comments_required() const
+{
+    if (generate_message_comments())
+        return true;
+
+    const auto refers_to_comments = [](const std::string &t) {
+        return t.find("comment") != std::string::npos;
+    };
+
+    const auto any_refers_to_comments =
+        [&refers_to_comments](const std::vector<std::string> &templates) {
+            return std::any_of(
+                templates.begin(), templates.end(), refers_to_comments);
+        };
+
+    return any_refers_to_comments(puml().before) ||
+        any_refers_to_comments(puml().after) ||
+        any_refers_to_comments(mermaid().before) ||
+        any_refers_to_comments(mermaid().after) ||
+        refers_to_comments(generate_links().link) ||
+        refers_to_comments(generate_links().tooltip);
+}
+
 std::optional<std::string> diagram::get_together_group(
     const std::string &full_name) const
 {
@@ -643,6 +643,17 @@ struct diagram : public inheritable_diagram_options {
     std::optional<std::string> get_together_group(
         const std::string &full_name) const;
 
+    /**
+     * @brief Check whether diagram element comments are used by templates
+     *
+     * Comments are used when message comments are enabled or when any of the
+     * PlantUML or MermaidJS directives, or link templates refers to them.
+     * Comment directives (e.g. `@uml{note}`) are not affected by this.
+     *
+     * @return True, if diagram element comments are used
+     */
+    bool comments_required() const;
+
     /**
      * @brief Initialize predefined set of C++ type aliases
      *
@@ -680,6 +691,8 @@ struct sequence_diagram : public diagram {
         option_with_alt_names_tag{}, "from", {"start_from"}};
     option<std::vector<std::vector<source_location>>> from_to{"from_to"};
     option<std::vector<source_location>> to{"to"};
+    option<unsigned> message_chains_limit{"message_chains_limit", 0};
+    option<unsigned> message_chains_max_depth{"message_chains_max_depth", 0};
 };
 
 /**
@@ -228,6 +228,8 @@ types:
         from: !optional [source_location_t]
         from_to: !optional [[source_location_t]]
         to: !optional [source_location_t]
+        message_chains_limit: !optional int
+        message_chains_max_depth: !optional int
     package_diagram_t:
         type: !variant [package]
         #
@@ -664,6 +664,8 @@ template <> struct convert<sequence_diagram> {
         get_option(node, rhs.from);
         get_option(node, rhs.from_to);
         get_option(node, rhs.to);
+        get_option(node, rhs.message_chains_limit);
+        get_option(node, rhs.message_chains_max_depth);
         get_option(node, rhs.combine_free_functions_into_file_participants);
         get_option(node, rhs.inline_lambda_messages);
         get_option(node, rhs.generate_return_types);
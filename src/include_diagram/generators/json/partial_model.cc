@@ -0,0 +1,87 @@
+/**
+ * @file src/include_diagram/generators/json/partial_model.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_model.h"
+
+#include "common/generators/json/partial_model.h"
+
+namespace clanguml::include_diagram::generators::json {
+
+using namespace clanguml::common::generators::json;
+using clanguml::common::model::source_file;
+using clanguml::common::model::source_file_t;
+
+namespace {
+nlohmann::json export_file(const source_file &f)
+{
+    nlohmann::json j;
+    export_diagram_element(f, j);
+    export_style(f, j);
+
+    j["path"] = f.path().is_empty() ? std::string{} : f.fs_path().string();
+    j["file_kind"] = to_string(f.type());
+    j["is_system"] = f.is_system_header();
+
+    return j;
+}
+
+std::unique_ptr<source_file> import_file(const nlohmann::json &j)
+{
+    const auto path = j.at("path").get<std::string>();
+
+    auto f = path.empty()
+        ? std::make_unique<source_file>()
+        : std::make_unique<source_file>(std::filesystem::path{path});
+
+    import_diagram_element(j, *f);
+    import_style(j, *f);
+
+    f->set_type(enum_from_string(j.at("file_kind").get<std::string>(),
+        {source_file_t::kHeader, source_file_t::kImplementation}));
+    f->set_system_header(j.at("is_system").get<bool>());
+
+    return f;
+}
+} // namespace
+
+nlohmann::json export_partial_model(const model::diagram &model)
+{
+    auto files = nlohmann::json::array();
+
+    for (const auto &f : model.view()) {
+        const source_file &file = f;
+
+        if (file.type() == source_file_t::kDirectory)
+            continue;
+
+        files.push_back(export_file(file));
+    }
+
+    return {{"files", std::move(files)}};
+}
+
+void import_partial_models(
+    const std::vector<nlohmann::json> &partial_models, model::diagram &model)
+{
+    // Files included from translation units in different shards are present
+    // in each of their partial models
+    for (const auto &j : merge_elements(partial_models, "files"))
+        model.add_file(import_file(j));
+}
+
+} // namespace clanguml::include_diagram::generators::json
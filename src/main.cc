@@ -18,7 +18,9 @@
 
 #include "cli/cli_handler.h"
 #include "common/compilation_database.h"
+#include "common/generators/diagram_server.h"
 #include "common/generators/generators.h"
+#include "util/file_watcher.h"
 #include "util/query_driver_output_extractor.h"
 #include "util/util.h"
 
@@ -31,7 +33,9 @@
 #include <cli11/CLI11.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cstring>
+#include <set>
 
 #ifdef ENABLE_BACKWARD_CPP
 namespace backward {
@@ -41,6 +45,135 @@ backward::SignalHandling sh; // NOLINT
 
 using namespace clanguml;
 
+namespace {
+using translation_units_map_t = std::map<std::string /* diagram name */,
+    std::vector<std::string> /* translation units */>;
+
+using dependencies_map_t = std::map<std::string /* diagram name */,
+    std::set<std::string> /* files */>;
+
+translation_units_map_t find_translation_units(
+    cli::cli_handler &cli, const common::compilation_database &db)
+{
+    const auto compilation_database_files = db.getAllFiles();
+
+    translation_units_map_t translation_units_map;
+
+    // We have to generate the translation units list for each diagram
+    // before scheduling tasks, because std::filesystem::current_path
+    // cannot be trusted with multiple threads
+    common::generators::find_translation_units_for_diagrams(cli.diagram_names,
+        cli.config, compilation_database_files, translation_units_map);
+
+    return translation_units_map;
+}
+
+/**
+ * Return files which require reloading the configuration and compilation
+ * database when modified.
+ */
+std::set<std::string> find_config_files(const cli::cli_handler &cli)
+{
+    std::set<std::string> result;
+
+    if (cli.config_path != "-")
+        result.emplace(util::ensure_path_is_absolute(cli.config_path)
+                           .lexically_normal()
+                           .string());
+
+    const std::filesystem::path db_dir{cli.config.compilation_database_dir()};
+    for (const auto *file : {"compile_commands.json", "compile_flags.txt"})
+        result.emplace((db_dir / file).lexically_normal().string());
+
+    return result;
+}
+
+/**
+ * Generate diagrams and then keep regenerating the diagrams affected by
+ * modified files, until the process is terminated.
+ */
+void watch_diagrams(cli::cli_handler &cli)
+{
+    auto db =
+        common::compilation_database::auto_detect_from_directory(cli.config);
+    auto translation_units_map = find_translation_units(cli, *db);
+
+    dependencies_map_t dependencies;
+    std::vector<std::string> diagram_names{cli.diagram_names};
+
+    util::file_watcher watcher;
+
+    while (true) {
+        common::generators::generate_diagrams(diagram_names, cli.config, db,
+            cli.get_runtime_config(), translation_units_map, &dependencies);
+
+        // Watch the translation units also for diagrams, which failed
+        // before their dependencies could be recorded
+        for (const auto &[name, translation_units] : translation_units_map) {
+            for (const auto &tu : translation_units)
+                dependencies[name].emplace(
+                    std::filesystem::path{tu}.lexically_normal().string());
+        }
+
+        const auto config_files = find_config_files(cli);
+
+        std::set<std::string> watched_files{config_files};
+        for (const auto &[name, files] : dependencies)
+            watched_files.insert(files.begin(), files.end());
+
+        watcher.watch(watched_files);
+
+        diagram_names.clear();
+
+        while (diagram_names.empty()) {
+            LOG_INFO("Watching {} files for changes", watched_files.size());
+
+            const auto changed = watcher.wait();
+
+            auto is_changed = [&changed](const auto &file) {
+                return changed.count(file) > 0;
+            };
+
+            if (std::any_of(
+                    config_files.begin(), config_files.end(), is_changed)) {
+                LOG_INFO("Configuration or compilation database changed, "
+                         "regenerating all diagrams");
+
+                if (cli.reload_config() != cli::cli_flow_t::kContinue)
+                    continue;
+
+                try {
+                    db = common::compilation_database::
+                        auto_detect_from_directory(cli.config);
+                }
+                catch (error::compilation_database_error &e) {
+                    LOG_ERROR("Failed to load compilation database from {} "
+                              "due to: {}",
+                        cli.config.compilation_database_dir(), e.what());
+                    continue;
+                }
+
+                translation_units_map = find_translation_units(cli, *db);
+                dependencies.clear();
+                // Empty list means all diagrams, unless specific diagrams
+                // were requested on the command line
+                diagram_names = cli.diagram_names;
+                break;
+            }
+
+            for (const auto &[name, files] : dependencies) {
+                if (std::any_of(files.begin(), files.end(), is_changed))
+                    diagram_names.emplace_back(name);
+            }
+
+            if (!diagram_names.empty())
+                LOG_INFO("Regenerating diagrams {} after changes in {}",
+                    fmt::join(diagram_names, ", "), fmt::join(changed, ", "));
+        }
+    }
+}
+} // namespace
+
 int main(int argc, const char *argv[])
 {
     cli::cli_handler cli;
@@ -60,25 +193,59 @@ int main(int argc, const char *argv[])
 #endif
 
     try {
+        // Merging partial models of shards does not need the compilation
+        // database
+        if (cli.merge) {
+            const auto failed_count = common::generators::merge_diagrams(
+                cli.diagram_names, cli.config, cli.get_runtime_config());
+            return failed_count > 0 ? 1 : 0;
+        }
+
+        if (cli.watch) {
+            try {
+                watch_diagrams(cli);
+            }
+            catch (error::compilation_database_error &) {
+                throw;
+            }
+            catch (error::query_driver_no_paths &) {
+                throw;
+            }
+            catch (std::runtime_error &e) {
+                // File watcher could not be initialized or failed
+                LOG_ERROR("{}", e.what());
+                return 1;
+            }
+            return 0;
+        }
+
         const auto db =
             common::compilation_database::auto_detect_from_directory(
                 cli.config);
 
-        const auto compilation_database_files = db->getAllFiles();
+        auto translation_units_map = find_translation_units(cli, *db);
 
-        std::map<std::string /* diagram name */,
-            std::vector<std::string> /* translation units */>
-            translation_units_map;
+#if !defined(_WIN32)
+        if (cli.daemon_socket) {
+            common::generators::diagram_server server{cli.config, *db,
+                cli.get_runtime_config(), std::move(translation_units_map)};
+            try {
+                server.run(*cli.daemon_socket);
+            }
+            catch (std::runtime_error &e) {
+                LOG_ERROR("{}", e.what());
+                return 1;
+            }
+            return 0;
+        }
+#endif
 
-        // We have to generate the translation units list for each diagram
-        // before scheduling tasks, because std::filesystem::current_path
-        // cannot be trusted with multiple threads
-        common::generators::find_translation_units_for_diagrams(
-            cli.diagram_names, cli.config, compilation_database_files,
+        const auto failed_renders = common::generators::generate_diagrams(
+            cli.diagram_names, cli.config, db, cli.get_runtime_config(),
             translation_units_map);
 
-        common::generators::generate_diagrams(cli.diagram_names, cli.config, db,
-            cli.get_runtime_config(), translation_units_map);
+        if (failed_renders > 0)
+            return 1;
     }
     catch (error::compilation_database_error &e) {
         LOG_ERROR("Failed to load compilation database from {} due to: {}",
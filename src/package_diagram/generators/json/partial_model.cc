@@ -0,0 +1,49 @@
+/**
+ * @file src/package_diagram/generators/json/partial_model.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_model.h"
+
+#include "common/generators/json/partial_model.h"
+
+namespace clanguml::package_diagram::generators::json {
+
+using namespace clanguml::common::generators::json;
+using clanguml::common::model::element;
+using clanguml::common::model::package;
+
+nlohmann::json export_partial_model(const model::diagram &model)
+{
+    auto elements = nlohmann::json::array();
+    export_elements(
+        model,
+        [](const element &e) {
+            return export_package(dynamic_cast<const package &>(e));
+        },
+        elements);
+
+    return {{"elements", std::move(elements)}};
+}
+
+void import_partial_models(
+    const std::vector<nlohmann::json> &partial_models, model::diagram &model)
+{
+    for (const auto &j : merge_elements(partial_models, "elements"))
+        add_element(model, j, import_package(j));
+}
+
+} // namespace clanguml::package_diagram::generators::json
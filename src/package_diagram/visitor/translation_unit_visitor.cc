@@ -41,6 +41,24 @@ translation_unit_visitor::translation_unit_visitor(clang::SourceManager &sm,
 {
 }
 
+bool translation_unit_visitor::TraverseNamespaceDecl(clang::NamespaceDecl *ns)
+{
+    assert(ns != nullptr);
+
+    if (config().package_type() == config::package_type_t::kNamespace) {
+        // Namespaces from system headers can still become packages, so
+        // only namespaces excluded by the diagram filters can be skipped
+        if (is_namespace_excluded(*ns))
+            return true;
+    }
+    else if (source_manager().isInSystemHeader(ns->getLocation())) {
+        return true;
+    }
+
+    return RecursiveASTVisitor<translation_unit_visitor>::TraverseNamespaceDecl(
+        ns);
+}
+
 bool translation_unit_visitor::VisitNamespaceDecl(clang::NamespaceDecl *ns)
 {
     assert(ns != nullptr);
@@ -69,6 +69,8 @@ public:
      * \defgroup Implementation of ResursiveASTVisitor methods
      * @{
      */
+    virtual bool TraverseNamespaceDecl(clang::NamespaceDecl *ns);
+
     virtual bool VisitNamespaceDecl(clang::NamespaceDecl *ns);
 
     virtual bool VisitEnumDecl(clang::EnumDecl *decl);
@@ -0,0 +1,250 @@
+/**
+ * @file src/sequence_diagram/generators/json/partial_model.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_model.h"
+
+#include "common/generators/json/partial_model.h"
+
+namespace clanguml::sequence_diagram::generators::json {
+
+using namespace clanguml::common::generators::json;
+using clanguml::common::model::message_scope_t;
+using clanguml::common::model::message_t;
+using model::activity;
+using model::class_;
+using model::function;
+using model::function_template;
+using model::message;
+using model::method;
+using model::participant;
+
+namespace {
+nlohmann::json export_participant(const participant &p)
+{
+    nlohmann::json j;
+    export_element(p, j);
+    export_template_element(p, j);
+    export_style(p, j);
+
+    if (const auto *c = dynamic_cast<const class_ *>(&p); c != nullptr) {
+        j["is_struct"] = c->is_struct();
+        j["is_template"] = c->is_template();
+        j["is_template_instantiation"] = c->is_template_instantiation();
+        j["is_alias"] = c->is_alias();
+        j["is_lambda"] = c->is_lambda();
+        j["lambda_operator_id"] = export_id(c->lambda_operator_id());
+    }
+
+    if (const auto *f = dynamic_cast<const function *>(&p); f != nullptr) {
+        j["is_const"] = f->is_const();
+        j["is_void"] = f->is_void();
+        j["is_static"] = f->is_static();
+        j["is_operator"] = f->is_operator();
+        j["is_cuda_kernel"] = f->is_cuda_kernel();
+        j["is_cuda_device"] = f->is_cuda_device();
+        j["return_type"] = f->return_type();
+        j["parameters"] = f->parameters();
+    }
+
+    if (const auto *m = dynamic_cast<const method *>(&p); m != nullptr) {
+        j["class_id"] = export_id(m->class_id());
+        j["method_name"] = m->method_name();
+        j["class_full_name"] = m->class_full_name();
+        j["is_constructor"] = m->is_constructor();
+        j["is_defaulted"] = m->is_defaulted();
+        j["is_assignment"] = m->is_assignment();
+    }
+
+    return j;
+}
+
+void import_function(const nlohmann::json &j, function &f)
+{
+    f.is_const(j.at("is_const").get<bool>());
+    f.is_void(j.at("is_void").get<bool>());
+    f.is_static(j.at("is_static").get<bool>());
+    f.is_operator(j.at("is_operator").get<bool>());
+    f.is_cuda_kernel(j.at("is_cuda_kernel").get<bool>());
+    f.is_cuda_device(j.at("is_cuda_device").get<bool>());
+    f.return_type(j.at("return_type").get<std::string>());
+    for (const auto &a : j.at("parameters"))
+        f.add_parameter(a.get<std::string>());
+}
+
+std::unique_ptr<participant> import_participant(const nlohmann::json &j)
+{
+    const auto type = j.at("type").get<std::string>();
+
+    std::unique_ptr<participant> result;
+
+    if (type == "class" || type == "lambda") {
+        auto c = make_element<class_>(j);
+        c->is_struct(j.at("is_struct").get<bool>());
+        c->is_template(j.at("is_template").get<bool>());
+        c->is_template_instantiation(
+            j.at("is_template_instantiation").get<bool>());
+        c->is_alias(j.at("is_alias").get<bool>());
+        c->is_lambda(j.at("is_lambda").get<bool>());
+        c->set_lambda_operator_id(import_id(j.at("lambda_operator_id")));
+        result = std::move(c);
+    }
+    else if (type == "function") {
+        auto f = make_element<function>(j);
+        import_function(j, *f);
+        result = std::move(f);
+    }
+    else if (type == "function_template") {
+        auto f = make_element<function_template>(j);
+        import_function(j, *f);
+        result = std::move(f);
+    }
+    else if (type == "method") {
+        auto m = make_element<method>(j);
+        import_function(j, *m);
+        m->set_class_id(import_id(j.at("class_id")));
+        m->set_method_name(j.at("method_name").get<std::string>());
+        m->set_class_full_name(j.at("class_full_name").get<std::string>());
+        m->is_constructor(j.at("is_constructor").get<bool>());
+        m->is_defaulted(j.at("is_defaulted").get<bool>());
+        m->is_assignment(j.at("is_assignment").get<bool>());
+        result = std::move(m);
+    }
+    else {
+        throw std::runtime_error(fmt::format(
+            "Invalid participant type '{}' in partial model", type));
+    }
+
+    import_template_element(j, *result);
+    import_style(j, *result);
+
+    return result;
+}
+
+nlohmann::json export_message(const message &m)
+{
+    nlohmann::json j;
+    j["type"] = to_string(m.type());
+    j["from"] = export_id(m.from());
+    j["to"] = export_id(m.to());
+    j["name"] = m.message_name();
+    j["return_type"] = m.return_type();
+    j["scope"] = to_string(m.message_scope());
+    j["in_static_declaration_context"] = m.in_static_declaration_context();
+    if (const auto &comment = m.comment(); comment)
+        j["comment"] = comment.value();
+    if (const auto &text = m.condition_text(); text)
+        j["condition_text"] = text.value();
+
+    export_source_location(m, j);
+    j["decorators"] = export_decorators(m);
+
+    return j;
+}
+
+message import_message(const nlohmann::json &j)
+{
+    const auto type = enum_from_string(j.at("type").get<std::string>(),
+        {message_t::kCall, message_t::kReturn, message_t::kIf,
+            message_t::kElse, message_t::kElseIf, message_t::kIfEnd,
+            message_t::kWhile, message_t::kWhileEnd, message_t::kDo,
+            message_t::kDoEnd, message_t::kFor, message_t::kForEnd,
+            message_t::kTry, message_t::kCatch, message_t::kTryEnd,
+            message_t::kSwitch, message_t::kCase, message_t::kSwitchEnd,
+            message_t::kConditional, message_t::kConditionalElse,
+            message_t::kConditionalEnd});
+
+    message m{type, import_id(j.at("from"))};
+    m.set_to(import_id(j.at("to")));
+    m.set_message_name(j.at("name").get<std::string>());
+    m.set_return_type(j.at("return_type").get<std::string>());
+    m.set_message_scope(enum_from_string(j.at("scope").get<std::string>(),
+        {message_scope_t::kNormal, message_scope_t::kCondition}));
+    m.in_static_declaration_context(
+        j.at("in_static_declaration_context").get<bool>());
+    if (j.contains("comment"))
+        m.set_comment(j.at("comment").get<std::string>());
+    if (j.contains("condition_text"))
+        m.condition_text(j.at("condition_text").get<std::string>());
+
+    import_source_location(j, m);
+    import_decorators(j, m);
+
+    return m;
+}
+} // namespace
+
+nlohmann::json export_partial_model(const model::diagram &model)
+{
+    auto participants = nlohmann::json::array();
+    for (const auto &[id, p] : model.participants())
+        participants.push_back(export_participant(*p));
+
+    auto activities = nlohmann::json::array();
+    for (const auto &[id, a] : model.sequences()) {
+        if (!id.is_global())
+            continue;
+
+        auto messages = nlohmann::json::array();
+        for (const auto &m : a.messages()) {
+            // Callees, whose AST local id was not resolved to a global id,
+            // cannot be found in other shards either
+            if (!m.from().is_global() || !m.to().is_global())
+                continue;
+
+            messages.push_back(export_message(m));
+        }
+
+        activities.push_back({{"participant_id", export_id(a.from())},
+            {"messages", std::move(messages)}});
+    }
+
+    auto active_participants = nlohmann::json::array();
+    for (const auto &id : model.active_participants())
+        active_participants.push_back(export_id(id));
+
+    return {{"participants", std::move(participants)},
+        {"activities", std::move(activities)},
+        {"active_participants", std::move(active_participants)}};
+}
+
+void import_partial_models(
+    const std::vector<nlohmann::json> &partial_models, model::diagram &model)
+{
+    for (const auto &partial_model : partial_models) {
+        // Participants found by multiple shards are the same, so the first
+        // one is kept
+        for (const auto &p : partial_model.at("participants"))
+            model.add_participant(import_participant(p));
+
+        for (const auto &a : partial_model.at("activities")) {
+            const auto id = import_id(a.at("participant_id"));
+
+            auto it = model.sequences().find(id);
+            if (it == model.sequences().end())
+                it = model.sequences().emplace(id, activity{id}).first;
+
+            for (const auto &m : a.at("messages"))
+                it->second.add_message(import_message(m));
+        }
+
+        for (const auto &id : partial_model.at("active_participants"))
+            model.add_active_participant(import_id(id));
+    }
+}
+
+} // namespace clanguml::sequence_diagram::generators::json
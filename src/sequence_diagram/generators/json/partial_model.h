@@ -0,0 +1,52 @@
+/**
+ * @file src/sequence_diagram/generators/json/partial_model.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "sequence_diagram/model/diagram.h"
+
+#include <nlohmann/json.hpp>
+
+#include <vector>
+
+namespace clanguml::sequence_diagram::generators::json {
+
+/**
+ * @brief Export sequence diagram model built by a single shard
+ *
+ * The model must be exported before it is finalized, as calls to
+ * participants found by other shards would be removed from it.
+ *
+ * @param model Partial sequence diagram model
+ * @return Partial model
+ */
+nlohmann::json export_partial_model(const model::diagram &model);
+
+/**
+ * @brief Import partial models of all shards into a sequence diagram model
+ *
+ * Messages of each activity are appended in shard order, just like they are
+ * appended in the order of translation units when the diagram is generated
+ * in a single run.
+ *
+ * @param partial_models Partial models of all shards, in shard order
+ * @param model Sequence diagram model to import the partial models into
+ */
+void import_partial_models(
+    const std::vector<nlohmann::json> &partial_models, model::diagram &model);
+
+} // namespace clanguml::sequence_diagram::generators::json
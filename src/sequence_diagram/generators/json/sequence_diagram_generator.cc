@@ -61,7 +61,6 @@ void to_json(nlohmann::json &j, const activity &c)
 namespace clanguml::sequence_diagram::generators::json {
 
 using clanguml::common::model::message_t;
-using clanguml::config::location_t;
 using clanguml::sequence_diagram::model::activity;
 using clanguml::sequence_diagram::model::message;
 using namespace clanguml::util;
@@ -527,20 +526,6 @@ void generator::process_if_message(const message &m) const
         std::ref(current_block_statement()["branches"].back()));
 }
 
-void generator::generate_participant(
-    nlohmann::json &parent, const std::string &name) const
-{
-    auto p = model().get(name);
-
-    if (!p.has_value()) {
-        LOG_WARN("Cannot find participant {} from `participants_order` option",
-            name);
-        return;
-    }
-
-    generate_participant(parent, p.value().id(), true);
-}
-
 std::optional<eid_t> generator::generate_participant(
     nlohmann::json & /*parent*/, eid_t id, bool force) const
 {
@@ -686,37 +671,23 @@ void generator::generate_diagram(nlohmann::json &parent) const
     if (config().using_namespace)
         parent["using_namespace"] = config().using_namespace().to_string();
 
-    if (config().participants_order.has_value) {
-        for (const auto &p : config().participants_order()) {
-            LOG_DBG("Pregenerating participant {}", p);
-            generate_participant(json_, p);
-        }
-    }
-
-    for (const auto &ft : config().from_to()) {
-        // First, find the sequence of activities from 'from' location
-        // to 'to' location
-        assert(ft.size() == 2);
-
-        const auto &from_location = ft.front();
-        const auto &to_location = ft.back();
-
-        auto from_activity_id = model().get_from_activity_id(from_location);
-        auto to_activity_id = model().get_to_activity_id(to_location);
+    const auto &plan = model().get_render_plan(config());
 
-        if (!from_activity_id || !to_activity_id)
-            continue;
+    for (const auto p : plan.participants_order) {
+        LOG_DBG("Pregenerating participant {}", p);
+        generate_participant(json_, p, true);
+    }
 
-        auto message_chains_unique = model().get_all_from_to_message_chains(
-            *from_activity_id, *to_activity_id);
+    for (const auto &ft : plan.from_to) {
+        const auto &message_chains_unique = ft.message_chains;
 
         nlohmann::json sequence;
-        sequence["from_to"]["from"]["location"] = from_location.location;
+        sequence["from_to"]["from"]["location"] = ft.from_location->location;
         sequence["from_to"]["from"]["id"] =
-            std::to_string(from_activity_id.value().value());
-        sequence["from_to"]["to"]["location"] = to_location.location;
+            std::to_string(ft.from_activity_id.value().value());
+        sequence["from_to"]["to"]["location"] = ft.to_location.location;
         sequence["from_to"]["to"]["id"] =
-            std::to_string(to_activity_id.value().value());
+            std::to_string(ft.to_activity_id.value());
 
         block_statements_stack_.push_back(std::ref(sequence));
 
@@ -741,18 +712,12 @@ void generator::generate_diagram(nlohmann::json &parent) const
         parent["sequences"].push_back(std::move(sequence));
     }
 
-    for (const auto &to_location : config().to()) {
-        auto to_activity_id = model().get_to_activity_id(to_location);
-
-        if (!to_activity_id.has_value())
-            continue;
-
-        auto message_chains_unique = model().get_all_from_to_message_chains(
-            eid_t{}, to_activity_id.value());
+    for (const auto &t : plan.to) {
+        const auto &message_chains_unique = t.message_chains;
 
         nlohmann::json sequence;
-        sequence["to"]["location"] = to_location.location;
-        sequence["to"]["id"] = std::to_string(to_activity_id.value().value());
+        sequence["to"]["location"] = t.to_location.location;
+        sequence["to"]["id"] = std::to_string(t.to_activity_id.value());
 
         block_statements_stack_.push_back(std::ref(sequence));
 
@@ -777,69 +742,45 @@ void generator::generate_diagram(nlohmann::json &parent) const
         parent["sequences"].push_back(std::move(sequence));
     }
 
-    for (const auto &sf : config().from()) {
-        if (sf.location_type == location_t::function) {
-            eid_t start_from{};
-            std::string start_from_str;
-            for (const auto &[k, v] : model().sequences()) {
-                const auto &caller = *model().participants().at(v.from());
-                std::string vfrom = caller.full_name(false);
-                if (vfrom == sf.location) {
-                    LOG_DBG("Found sequence diagram start point: {}", k);
-                    start_from = k;
-                    break;
-                }
-            }
-
-            if (start_from == 0) {
-                LOG_WARN("Failed to find participant with {} for start_from "
-                         "condition",
-                    sf.location);
-                continue;
-            }
+    for (const auto &sf : plan.from) {
+        const auto start_from = sf.start_from;
 
-            // Use this to break out of recurrent loops
-            std::vector<eid_t> visited_participants;
+        // Use this to break out of recurrent loops
+        std::vector<eid_t> visited_participants;
 
-            const auto &from =
-                model().get_participant<model::function>(start_from);
+        const auto &from = model().get_participant<model::function>(start_from);
 
-            if (!from.has_value()) {
-                LOG_WARN("Failed to find participant {} for start_from "
-                         "condition",
-                    sf.location);
-                continue;
-            }
+        if (!from.has_value()) {
+            LOG_WARN("Failed to find participant {} for start_from "
+                     "condition",
+                sf.from_location.location);
+            continue;
+        }
 
-            generate_participant(json_, start_from);
+        generate_participant(json_, start_from);
 
-            [[maybe_unused]] model::function::message_render_mode render_mode =
-                model::function::message_render_mode::full;
+        [[maybe_unused]] model::function::message_render_mode render_mode =
+            model::function::message_render_mode::full;
 
-            nlohmann::json sequence;
-            sequence["start_from"]["location"] = sf.location;
-            sequence["start_from"]["id"] = std::to_string(start_from.value());
+        nlohmann::json sequence;
+        sequence["start_from"]["location"] = sf.from_location.location;
+        sequence["start_from"]["id"] = std::to_string(start_from.value());
 
-            block_statements_stack_.push_back(std::ref(sequence));
+        block_statements_stack_.push_back(std::ref(sequence));
 
-            generate_activity(
-                model().get_activity(start_from), visited_participants);
+        generate_activity(
+            model().get_activity(start_from), visited_participants);
 
-            block_statements_stack_.pop_back();
-
-            if (from.value().type_name() == "method" ||
-                config().combine_free_functions_into_file_participants()) {
+        block_statements_stack_.pop_back();
 
-                sequence["return_type"] =
-                    make_display_name(from.value().return_type());
-            }
+        if (from.value().type_name() == "method" ||
+            config().combine_free_functions_into_file_participants()) {
 
-            parent["sequences"].push_back(std::move(sequence));
-        }
-        else {
-            // TODO: Add support for other sequence start location types
-            continue;
+            sequence["return_type"] =
+                make_display_name(from.value().return_type());
         }
+
+        parent["sequences"].push_back(std::move(sequence));
     }
 
     // Perform config dependent postprocessing on generated participants
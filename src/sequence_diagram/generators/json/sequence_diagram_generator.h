@@ -82,17 +82,6 @@ public:
     std::optional<eid_t> generate_participant(
         nlohmann::json &parent, eid_t id, bool force = false) const;
 
-    /**
-     * @brief Generate sequence diagram participant by name
-     *
-     * This is convienience wrapper over `generate_participant()` by id.
-     *
-     * @param parent JSON node
-     * @param name Full participant name
-     */
-    void generate_participant(
-        nlohmann::json &parent, const std::string &name) const;
-
     /**
      * @brief Generate sequence diagram activity.
      *
@@ -21,7 +21,6 @@
 namespace clanguml::sequence_diagram::generators::mermaid {
 
 using clanguml::common::model::message_t;
-using clanguml::config::location_t;
 using clanguml::sequence_diagram::model::activity;
 using clanguml::sequence_diagram::model::message;
 using namespace clanguml::util;
@@ -337,20 +336,6 @@ void generator::generate_activity(
     }
 }
 
-void generator::generate_participant(
-    std::ostream &ostr, const std::string &name) const
-{
-    auto p = model().get(name);
-
-    if (!p.has_value()) {
-        LOG_WARN("Cannot find participant {} from `participants_order` option",
-            name);
-        return;
-    }
-
-    generate_participant(ostr, p.value().id(), true);
-}
-
 void generator::generate_participant(
     std::ostream &ostr, eid_t id, bool force) const
 {
@@ -485,37 +470,25 @@ void generator::generate_diagram(std::ostream &ostr) const
 {
     model().print();
 
-    if (config().participants_order.has_value) {
-        for (const auto &p : config().participants_order()) {
-            LOG_DBG("Pregenerating participant {}", p);
-            generate_participant(ostr, p);
-        }
+    const auto &plan = model().get_render_plan(config());
+
+    for (const auto p : plan.participants_order) {
+        LOG_DBG("Pregenerating participant {}", p);
+        generate_participant(ostr, p, true);
     }
 
     bool star_participant_generated{false};
 
-    for (const auto &ft : config().from_to()) {
-        // First, find the sequence of activities from 'from' location
-        // to 'to' location
-        assert(ft.size() == 2);
-
-        const auto &from_location = ft.front();
-        const auto &to_location = ft.back();
-
-        auto from_activity_id = model().get_from_activity_id(from_location);
-        auto to_activity_id = model().get_to_activity_id(to_location);
-
-        if (!from_activity_id || !to_activity_id)
-            continue;
+    for (const auto &ft : plan.from_to) {
+        const auto &from_activity_id = ft.from_activity_id;
 
         if (model().participants().count(*from_activity_id) == 0)
             continue;
 
-        if (model().participants().count(*to_activity_id) == 0)
+        if (model().participants().count(ft.to_activity_id) == 0)
             continue;
 
-        auto message_chains_unique = model().get_all_from_to_message_chains(
-            *from_activity_id, *to_activity_id);
+        const auto &message_chains_unique = ft.message_chains;
 
         for (const auto &mc : message_chains_unique) {
             const auto &from =
@@ -543,14 +516,8 @@ void generator::generate_diagram(std::ostream &ostr) const
         }
     }
 
-    for (const auto &to_location : config().to()) {
-        auto to_activity_id = model().get_to_activity_id(to_location);
-
-        if (!to_activity_id)
-            continue;
-
-        auto message_chains_unique =
-            model().get_all_from_to_message_chains(eid_t{}, *to_activity_id);
+    for (const auto &t : plan.to) {
+        const auto &message_chains_unique = t.message_chains;
 
         for (const auto &mc : message_chains_unique) {
             const auto from_activity_id = mc.front().from();
@@ -579,93 +546,66 @@ void generator::generate_diagram(std::ostream &ostr) const
         }
     }
 
-    for (const auto &sf : config().from()) {
-        if (sf.location_type == location_t::function) {
-            eid_t start_from{};
-            for (const auto &[k, v] : model().sequences()) {
-                if (model().participants().count(v.from()) == 0)
-                    continue;
-
-                const auto &caller = *model().participants().at(v.from());
-                std::string vfrom = caller.full_name(false);
-                if (vfrom == sf.location) {
-                    LOG_DBG("Found sequence diagram start point: {}", k);
-                    start_from = k;
-                    break;
-                }
-            }
-
-            if (start_from == 0) {
-                LOG_WARN("Failed to find participant with {} for start_from "
-                         "condition",
-                    sf.location);
-                continue;
-            }
+    for (const auto &sf : plan.from) {
+        const auto start_from = sf.start_from;
 
-            // Use this to break out of recurrent loops
-            std::vector<eid_t> visited_participants;
+        // Use this to break out of recurrent loops
+        std::vector<eid_t> visited_participants;
 
-            if (model().participants().count(start_from) == 0)
-                continue;
+        if (model().participants().count(start_from) == 0)
+            continue;
 
-            const auto &from =
-                model().get_participant<model::function>(start_from);
+        const auto &from = model().get_participant<model::function>(start_from);
 
-            if (!from.has_value()) {
-                LOG_WARN("Failed to find participant {} for start_from "
-                         "condition",
-                    sf.location);
-                continue;
-            }
+        if (!from.has_value()) {
+            LOG_WARN("Failed to find participant {} for start_from "
+                     "condition",
+                sf.from_location.location);
+            continue;
+        }
 
-            generate_participant(ostr, start_from);
+        generate_participant(ostr, start_from);
 
-            std::string from_alias = generate_alias(from.value());
+        std::string from_alias = generate_alias(from.value());
 
-            model::function::message_render_mode render_mode =
-                select_method_arguments_render_mode();
+        model::function::message_render_mode render_mode =
+            select_method_arguments_render_mode();
 
-            // For methods or functions in diagrams where they are combined into
-            // file participants, we need to add an 'entry' point call to know
-            // which method relates to the first activity for this 'start_from'
-            // condition
-            if (from.value().type_name() == "method" ||
-                config().combine_free_functions_into_file_participants()) {
-                ostr << indent(1) << "* "
-                     << common::generators::mermaid::to_mermaid(
-                            message_t::kCall)
-                     << " " << from_alias << " : "
-                     << from.value().message_name(render_mode) << '\n';
-            }
+        // For methods or functions in diagrams where they are combined into
+        // file participants, we need to add an 'entry' point call to know
+        // which method relates to the first activity for this 'start_from'
+        // condition
+        if (from.value().type_name() == "method" ||
+            config().combine_free_functions_into_file_participants()) {
+            ostr << indent(1) << "* "
+                 << common::generators::mermaid::to_mermaid(message_t::kCall)
+                 << " " << from_alias << " : "
+                 << from.value().message_name(render_mode) << '\n';
+        }
 
-            ostr << indent(1) << "activate " << from_alias << '\n';
+        ostr << indent(1) << "activate " << from_alias << '\n';
 
-            generate_activity(
-                model().get_activity(start_from), ostr, visited_participants);
+        generate_activity(
+            model().get_activity(start_from), ostr, visited_participants);
 
-            if (from.value().type_name() == "method" ||
-                config().combine_free_functions_into_file_participants()) {
+        if (from.value().type_name() == "method" ||
+            config().combine_free_functions_into_file_participants()) {
 
-                if (!from.value().is_void()) {
-                    ostr << indent(1) << from_alias << " "
-                         << common::generators::mermaid::to_mermaid(
-                                message_t::kReturn)
-                         << " *"
-                         << " : ";
+            if (!from.value().is_void()) {
+                ostr << indent(1) << from_alias << " "
+                     << common::generators::mermaid::to_mermaid(
+                            message_t::kReturn)
+                     << " *"
+                     << " : ";
 
-                    if (config().generate_return_types())
-                        ostr << from.value().return_type();
+                if (config().generate_return_types())
+                    ostr << from.value().return_type();
 
-                    ostr << '\n';
-                }
+                ostr << '\n';
             }
-
-            ostr << indent(1) << "deactivate " << from_alias << '\n';
-        }
-        else {
-            // TODO: Add support for other sequence start location types
-            continue;
         }
+
+        ostr << indent(1) << "deactivate " << from_alias << '\n';
     }
 }
 
@@ -93,17 +93,6 @@ public:
     void generate_participant(
         std::ostream &ostr, eid_t id, bool force = false) const;
 
-    /**
-     * @brief Generate sequence diagram participant by name
-     *
-     * This is convienience wrapper over `generate_participant()` by id.
-     *
-     * @param ostr Output stream
-     * @param name Full participant name
-     */
-    void generate_participant(
-        std::ostream &ostr, const std::string &name) const;
-
     /**
      * @brief Generate sequence diagram activity.
      *
@@ -22,6 +22,7 @@
 
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
 namespace clanguml::sequence_diagram::model {
 
@@ -276,118 +277,135 @@ std::optional<eid_t> diagram::get_from_activity_id(
 }
 
 std::vector<message_chain_t> diagram::get_all_from_to_message_chains(
-    const eid_t from_activity, const eid_t to_activity) const
+    const eid_t from_activity, const eid_t to_activity,
+    const unsigned max_chains, const unsigned max_depth) const
 {
-    std::vector<message_chain_t> message_chains_unique{};
+    using common::model::message_t;
 
-    // Message (call) chains matching the specified from_to condition
-    std::vector<message_chain_t> message_chains;
+    std::vector<message_chain_t> message_chains_unique{};
 
-    // First find all 'to_activity' call targets in the sequences, i.e.
-    // all messages pointing to the final 'to_activity' activity
+    // Build an index of unique calls to each activity (callee -> callers),
+    // so that the chains can be built backwards from the 'to_activity'
+    // without rescanning all messages in the diagram
+    std::unordered_map<eid_t, std::vector<const message *>> callers_index;
     for (const auto &[k, v] : sequences()) {
         for (const auto &m : v.messages()) {
-            if (m.type() != common::model::message_t::kCall)
+            if (m.type() != message_t::kCall)
                 continue;
 
-            if (m.to() == to_activity) {
-                message_chains.emplace_back();
-                message_chains.back().push_back(m);
+            auto &callers = callers_index[m.to()];
+
+            // Messages from a single activity are indexed consecutively,
+            // so it's enough to check the tail for duplicates
+            bool is_duplicate{false};
+            for (auto it = callers.rbegin();
+                 it != callers.rend() && (*it)->from() == m.from(); it++) {
+                if (**it == m) {
+                    is_duplicate = true;
+                    break;
+                }
             }
+
+            if (!is_duplicate)
+                callers.push_back(&m);
         }
     }
 
-    std::map<unsigned int, std::vector<model::message>> calls_to_current_chain;
-    std::map<unsigned int, message_chain_t> current_chain;
-
-    int iter = 0;
-    while (true) {
-        bool added_message_to_some_chain{false};
-        // If target of current message matches any of the
-        // 'from' constraints in the last messages in
-        // current chains found on previous iteration - append
-        if (!calls_to_current_chain.empty()) {
-            for (auto &[message_chain_index, messages] :
-                calls_to_current_chain) {
-                for (auto &m : messages) {
-                    message_chains.push_back(
-                        current_chain[message_chain_index]);
-
-                    message_chains.back().push_back(std::move(m));
-                }
-            }
-            calls_to_current_chain.clear();
+    if (callers_index.count(to_activity) == 0)
+        return message_chains_unique;
+
+    const std::vector<const message *> no_callers{};
+    const auto callers_of =
+        [&](eid_t id) -> const std::vector<const message *> & {
+        auto it = callers_index.find(id);
+        if (it == callers_index.end())
+            return no_callers;
+        return it->second;
+    };
+
+    // Current chain of messages from the 'to_activity' backwards - it's shared
+    // between all chains with a common suffix
+    std::vector<const message *> current_chain;
+
+    // Stack of activities on the current chain, along with the index of the
+    // next caller to visit and whether the chain has been extended from it
+    struct chain_frame {
+        eid_t activity_id;
+        std::size_t next_caller{0};
+        bool extended{false};
+    };
+    std::vector<chain_frame> frames;
+    frames.push_back({to_activity});
+
+    const auto add_current_chain = [&]() {
+        if (from_activity.value() != 0 &&
+            current_chain.back()->from() != from_activity)
+            return;
+
+        message_chain_t mc;
+        mc.reserve(current_chain.size());
+        for (auto it = current_chain.rbegin(); it != current_chain.rend();
+             it++) {
+            mc.push_back(**it);
         }
+        message_chains_unique.emplace_back(std::move(mc));
+    };
 
-        LOG_TRACE("Message chains after iteration {}", iter++);
-        int message_chain_index{};
-        for (const auto &mc : message_chains) {
-            LOG_TRACE("\t{}: {}", message_chain_index++,
-                fmt::join(util::map<std::string>(mc,
-                              [](const model::message &m) -> std::string {
-                                  return m.message_name();
-                              }),
-                    "<-"));
+    while (!frames.empty()) {
+        if (max_chains > 0 && message_chains_unique.size() >= max_chains) {
+            LOG_DBG("Reached message chains limit {} for activity {}",
+                max_chains, to_activity);
+            break;
         }
 
-        for (auto i = 0U; i < message_chains.size(); i++) {
-            auto &mc = message_chains[i];
-            current_chain[i] = mc;
-            for (const auto &[k, v] : sequences()) {
-                for (const auto &m : v.messages()) {
-                    if (m.type() != common::model::message_t::kCall)
-                        continue;
-
-                    // Ignore recursive calls and call loops
-                    if (m.to() == m.from() ||
-                        std::any_of(
-                            cbegin(mc), cend(mc), [&m](const auto &msg) {
-                                return msg.to() == m.from();
-                            })) {
-                        continue;
-                    }
+        auto &frame = frames.back();
+        const auto &callers = callers_of(frame.activity_id);
 
-                    if (m.to() == mc.back().from()) {
-                        calls_to_current_chain[i].push_back(m);
-                        added_message_to_some_chain = true;
-                    }
-                }
-            }
+        const message *next{nullptr};
+        while (frame.next_caller < callers.size()) {
+            const auto *m = callers[frame.next_caller++];
 
-            // If there are more than one call to the current chain,
-            // duplicate it as many times as there are calls - 1
-            if (calls_to_current_chain.count(i) > 0 &&
-                !calls_to_current_chain[i].empty()) {
-                mc.push_back(calls_to_current_chain[i][0]);
-                calls_to_current_chain[i].erase(
-                    calls_to_current_chain[i].begin());
+            // All calls to the 'to_activity' start a new chain
+            if (frames.size() == 1) {
+                next = m;
+                break;
             }
-        }
 
-        // There is nothing more to find
-        if (!added_message_to_some_chain)
+            // Ignore recursive calls and call loops
+            if (m->to() == m->from() ||
+                std::any_of(frames.begin(), frames.end(),
+                    [m](const auto &f) { return f.activity_id == m->from(); }))
+                continue;
+
+            next = m;
             break;
-    }
+        }
 
-    // Reverse the message chains order (they were added starting from
-    // the destination activity)
-    for (auto &mc : message_chains) {
-        std::reverse(mc.begin(), mc.end());
+        if (next != nullptr) {
+            frame.extended = true;
+            current_chain.push_back(next);
 
-        if (mc.empty())
-            continue;
+            if (max_depth > 0 && current_chain.size() >= max_depth) {
+                add_current_chain();
+                current_chain.pop_back();
+            }
+            else {
+                frames.push_back({next->from()});
+            }
 
-        if (std::find(message_chains_unique.begin(),
-                message_chains_unique.end(), mc) != message_chains_unique.end())
             continue;
-
-        if (from_activity.value() == 0 ||
-            (mc.front().from() == from_activity)) {
-            message_chains_unique.push_back(mc);
         }
+
+        // There is nothing more to find for this chain
+        if (frames.size() > 1 && !frame.extended)
+            add_current_chain();
+
+        frames.pop_back();
+        if (!current_chain.empty())
+            current_chain.pop_back();
     }
 
-    LOG_TRACE("Message chains unique", iter++);
+    LOG_TRACE("Message chains unique");
     int message_chain_index{};
     for (const auto &mc : message_chains_unique) {
         LOG_TRACE("\t{}: {}", message_chain_index++,
@@ -401,6 +419,103 @@ std::vector<message_chain_t> diagram::get_all_from_to_message_chains(
     return message_chains_unique;
 }
 
+const model::render_plan &diagram::get_render_plan(
+    const config::sequence_diagram &config) const
+{
+    std::lock_guard<std::mutex> l(*render_plan_mutex_);
+
+    if (!render_plan_) {
+        render_plan_ =
+            std::make_unique<model::render_plan>(build_render_plan(config));
+    }
+
+    return *render_plan_;
+}
+
+model::render_plan diagram::build_render_plan(
+    const config::sequence_diagram &config) const
+{
+    model::render_plan plan;
+
+    if (config.participants_order.has_value) {
+        for (const auto &p : config.participants_order()) {
+            auto participant = get(p);
+
+            if (!participant.has_value()) {
+                LOG_WARN("Cannot find participant {} from `participants_order` "
+                         "option",
+                    p);
+                continue;
+            }
+
+            plan.participants_order.push_back(participant.value().id());
+        }
+    }
+
+    for (const auto &ft : config.from_to()) {
+        assert(ft.size() == 2);
+
+        const auto &from_location = ft.front();
+        const auto &to_location = ft.back();
+
+        auto from_activity_id = get_from_activity_id(from_location);
+        auto to_activity_id = get_to_activity_id(to_location);
+
+        if (!from_activity_id || !to_activity_id)
+            continue;
+
+        plan.from_to.push_back({from_location, to_location, from_activity_id,
+            *to_activity_id,
+            get_all_from_to_message_chains(*from_activity_id, *to_activity_id,
+                config.message_chains_limit(),
+                config.message_chains_max_depth())});
+    }
+
+    for (const auto &to_location : config.to()) {
+        auto to_activity_id = get_to_activity_id(to_location);
+
+        if (!to_activity_id)
+            continue;
+
+        plan.to.push_back({{}, to_location, {}, *to_activity_id,
+            get_all_from_to_message_chains(eid_t{}, *to_activity_id,
+                config.message_chains_limit(),
+                config.message_chains_max_depth())});
+    }
+
+    for (const auto &sf : config.from()) {
+        if (sf.location_type != config::location_t::function) {
+            // TODO: Add support for other sequence start location types
+            continue;
+        }
+
+        eid_t start_from{};
+        for (const auto &[k, v] : sequences()) {
+            if (participants().count(v.from()) == 0)
+                continue;
+
+            const auto &caller = *participants().at(v.from());
+            std::string vfrom = caller.full_name(false);
+            if (vfrom == sf.location) {
+                LOG_DBG("Found sequence diagram start point: {}", k);
+                start_from = k;
+                break;
+            }
+        }
+
+        if (start_from == 0) {
+            LOG_WARN("Failed to find participant with {} for start_from "
+                     "condition",
+                sf.location);
+            continue;
+        }
+
+        plan.from.push_back({sf, start_from});
+    }
+
+    return plan;
+}
+
 bool diagram::is_empty() const
 {
     return activities_.empty() || participants_.empty();
@@ -24,12 +24,59 @@
 #include "participant.h"
 
 #include <map>
+#include <mutex>
+#include <optional>
 #include <string>
 
 namespace clanguml::sequence_diagram::model {
 
 using message_chain_t = std::vector<sequence_diagram::model::message>;
 
+/**
+ * @brief Message chains resolved for a single `from_to` or `to` condition
+ */
+struct message_chains_sequence {
+    /*! Location of the 'from' end point (empty for `to` conditions) */
+    std::optional<config::source_location> from_location;
+    /*! Location of the 'to' end point */
+    config::source_location to_location;
+    /*! Id of the 'from' activity (empty for `to` conditions) */
+    std::optional<eid_t> from_activity_id;
+    /*! Id of the 'to' activity */
+    eid_t to_activity_id;
+    /*! Unique message chains between the end points */
+    std::vector<message_chain_t> message_chains;
+};
+
+/**
+ * @brief Activity resolved for a single `from` condition
+ */
+struct start_from_sequence {
+    /*! Location of the start point */
+    config::source_location from_location;
+    /*! Id of the start activity */
+    eid_t start_from;
+};
+
+/**
+ * @brief Generator independent render plan of a sequence diagram
+ *
+ * Resolving the `from`, `to` and `from_to` conditions against the model
+ * requires multiple scans of all activities and messages, thus it is
+ * done only once per diagram model and the result is shared by all
+ * generators (e.g. PlantUML, JSON and MermaidJS).
+ */
+struct render_plan {
+    /*! Resolved ids of participants from `participants_order` option */
+    std::vector<eid_t> participants_order;
+    /*! Resolved `from_to` conditions */
+    std::vector<message_chains_sequence> from_to;
+    /*! Resolved `to` conditions */
+    std::vector<message_chains_sequence> to;
+    /*! Resolved `from` conditions */
+    std::vector<start_from_sequence> from;
+};
+
 /**
  * @brief Model of a sequence diagram
  *
@@ -253,12 +300,18 @@ public:
      * If 'from_activity' is 0, this method will return all message chains
      * ending in 'to_activity'.
      *
+     * The chains are found using a depth-first search over an index of
+     * callers of each activity, starting from the 'to_activity'.
+     *
      * @param from_activity Source activity for from_to message chain
      * @param to_activity Target activity for from_to message chain
+     * @param max_chains Maximum number of returned chains (0 - no limit)
+     * @param max_depth Maximum number of messages in a chain (0 - no limit)
      * @return List of message chains
      */
     std::vector<message_chain_t> get_all_from_to_message_chains(
-        eid_t from_activity, eid_t to_activity) const;
+        eid_t from_activity, eid_t to_activity, unsigned max_chains = 0,
+        unsigned max_depth = 0) const;
 
     /**
      * @brief Get id of a 'to' activity
@@ -278,6 +331,19 @@ public:
     std::optional<eid_t> get_from_activity_id(
         const config::source_location &from_location) const;
 
+    /**
+     * @brief Get the render plan for this diagram
+     *
+     * The render plan is computed on first call and cached in the model, so
+     * that subsequent generators for the same diagram can reuse it. This
+     * method can be called concurrently from multiple generators.
+     *
+     * @param config Sequence diagram configuration
+     * @return Reference to the render plan
+     */
+    const model::render_plan &get_render_plan(
+        const config::sequence_diagram &config) const;
+
     /**
      * @brief Once the diagram is complete, run any final processing.
      *
@@ -346,11 +412,18 @@ private:
     bool inline_lambda_operator_call(
         eid_t id, model::activity &new_activity, const model::message &m);
 
+    model::render_plan build_render_plan(
+        const config::sequence_diagram &config) const;
+
     std::map<eid_t, activity> activities_;
 
     std::map<eid_t, std::unique_ptr<participant>> participants_;
 
     std::set<eid_t> active_participants_;
+
+    mutable std::unique_ptr<std::mutex> render_plan_mutex_{
+        std::make_unique<std::mutex>()};
+    mutable std::unique_ptr<model::render_plan> render_plan_;
 };
 
 } // namespace clanguml::sequence_diagram::model
@@ -51,18 +51,27 @@ void message::set_message_name(std::string name)
     message_name_ = std::move(name);
 }
 
-const std::string &message::message_name() const { return message_name_; }
+const std::string &message::message_name() const
+{
+    return message_name_.str();
+}
 
 void message::set_return_type(std::string t) { return_type_ = std::move(t); }
 
-const std::string &message::return_type() const { return return_type_; }
+const std::string &message::return_type() const { return return_type_.str(); }
 
-const std::optional<std::string> &message::comment() const { return comment_; }
+std::optional<std::string> message::comment() const
+{
+    if (comment_.empty())
+        return {};
+
+    return comment_.str();
+}
 
 void message::set_comment(std::string c)
 {
     if (!c.empty())
-        comment_ = std::move(c);
+        comment_ = c;
 }
 
 void message::set_comment(const std::optional<std::string> &c)
@@ -80,15 +89,15 @@ common::model::message_scope_t message::message_scope() const { return scope_; }
 
 void message::condition_text(const std::string &condition_text)
 {
-    if (condition_text.empty())
-        condition_text_ = std::nullopt;
-    else
-        condition_text_ = condition_text;
+    condition_text_ = condition_text;
 }
 
 std::optional<std::string> message::condition_text() const
 {
-    return condition_text_;
+    if (condition_text_.empty())
+        return {};
+
+    return condition_text_.str();
 }
 
 bool message::in_static_declaration_context() const
@@ -101,4 +110,14 @@ void message::in_static_declaration_context(bool v)
     in_static_declaration_context_ = v;
 }
 
+inja::json message::context() const
+{
+    inja::json ctx;
+    ctx["name"] = message_name();
+    ctx["type"] = "message";
+    ctx["full_name"] = message_name();
+
+    return ctx;
+}
+
 } // namespace clanguml::sequence_diagram::model
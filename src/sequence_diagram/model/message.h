@@ -17,8 +17,11 @@
  */
 #pragma once
 
+#include "common/model/decorated_element.h"
 #include "common/model/enums.h"
+#include "common/model/source_location.h"
 #include "participant.h"
+#include "util/interned_string.h"
 
 #include <string>
 #include <vector>
@@ -27,8 +30,15 @@ namespace clanguml::sequence_diagram::model {
 
 /**
  * @brief Model of a sequence diagram message.
+ *
+ * Sequence diagrams can contain very large number of messages, which are
+ * copied multiple times during diagram finalization and generation, thus
+ * messages are not diagram elements (they don't need names, ids or
+ * relationships) and all their string properties are interned. Copying a
+ * message only allocates memory if it has decorators.
  */
-class message : public common::model::diagram_element {
+class message : public common::model::decorated_element,
+                public common::model::source_location {
 public:
     message() = default;
 
@@ -118,7 +128,12 @@ public:
      */
     const std::string &return_type() const;
 
-    const std::optional<std::string> &comment() const;
+    /**
+     * @brief Get the message comment
+     *
+     * @return Message comment text, if any
+     */
+    std::optional<std::string> comment() const;
 
     void set_comment(std::string c);
 
@@ -159,6 +174,13 @@ public:
 
     void in_static_declaration_context(bool v);
 
+    /**
+     * @brief Return message JSON context for inja templates.
+     *
+     * @return Message context.
+     */
+    inja::json context() const;
+
 private:
     common::model::message_t type_{common::model::message_t::kNone};
 
@@ -171,13 +193,14 @@ private:
 
     // This is only for better verbose messages, we cannot rely on this
     // always
-    std::string message_name_{};
+    util::interned_string message_name_{};
 
-    std::string return_type_{};
+    util::interned_string return_type_{};
 
-    std::optional<std::string> condition_text_;
+    // Empty condition text or comment means there is none
+    util::interned_string condition_text_;
 
-    std::optional<std::string> comment_;
+    util::interned_string comment_;
 
     bool in_static_declaration_context_{false};
 };
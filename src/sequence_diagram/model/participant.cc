@@ -204,7 +204,10 @@ void method::set_class_full_name(const std::string &name)
     class_full_name_ = name;
 }
 
-const auto &method::class_full_name() const { return class_full_name_; }
+const std::string &method::class_full_name() const
+{
+    return class_full_name_;
+}
 
 std::string method::full_name(bool relative) const
 {
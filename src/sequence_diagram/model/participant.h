@@ -435,7 +435,7 @@ struct method : public function {
      *
      * @return Class full name
      */
-    const auto &class_full_name() const;
+    const std::string &class_full_name() const;
 
     /**
      * Return elements full name.
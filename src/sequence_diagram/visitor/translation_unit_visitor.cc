@@ -45,6 +45,19 @@ bool translation_unit_visitor::shouldVisitTemplateInstantiations()
     return true;
 }
 
+bool translation_unit_visitor::TraverseNamespaceDecl(clang::NamespaceDecl *ns)
+{
+    assert(ns != nullptr);
+
+    // Calls and declarations in system headers are never included, so
+    // there is no need to traverse namespaces such as `std`
+    if (source_manager().isInSystemHeader(ns->getLocation()))
+        return true;
+
+    return RecursiveASTVisitor<translation_unit_visitor>::TraverseNamespaceDecl(
+        ns);
+}
+
 call_expression_context &translation_unit_visitor::context()
 {
     return call_expression_context_;
@@ -2291,6 +2304,9 @@ std::optional<std::string> translation_unit_visitor::get_expression_comment(
     const clang::SourceManager &sm, const clang::ASTContext &context,
     const eid_t caller_id, const clang::Stmt *stmt)
 {
+    if (!parse_comments())
+        return {};
+
     const auto *raw_comment =
         clanguml::common::get_expression_raw_comment(sm, context, stmt);
 
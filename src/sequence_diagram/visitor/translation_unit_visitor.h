@@ -22,6 +22,7 @@
 #include "common/visitor/translation_unit_visitor.h"
 #include "config/config.h"
 #include "sequence_diagram/model/diagram.h"
+#include "util/flat_hash_map.h"
 
 #include <clang/AST/Expr.h>
 #include <clang/AST/RecursiveASTVisitor.h>
@@ -75,6 +76,8 @@ public:
      */
     bool shouldVisitTemplateInstantiations();
 
+    bool TraverseNamespaceDecl(clang::NamespaceDecl *ns);
+
     bool VisitCallExpr(clang::CallExpr *expr);
 
     bool TraverseVarDecl(clang::VarDecl *VD);
@@ -498,8 +501,9 @@ private:
      * expressions (e.g. a(b(c(), d())), as they need to be added to the diagram
      * sequence after the visitor leaves the call expression AST node
      */
-    std::map<clang::CallExpr *, model::message> call_expr_message_map_;
-    std::map<clang::CXXConstructExpr *, model::message>
+    util::flat_hash_map<clang::CallExpr *, model::message>
+        call_expr_message_map_;
+    util::flat_hash_map<clang::CXXConstructExpr *, model::message>
         construct_expr_message_map_;
 
     std::map<eid_t, std::unique_ptr<clanguml::sequence_diagram::model::class_>>
@@ -508,11 +512,11 @@ private:
     /**
      * @todo Refactor to @ref ast_id_mapper
      */
-    std::map</* local id from ->getID() */ int64_t,
+    util::flat_hash_map</* local id from ->getID() */ int64_t,
         /* global ID based on full name */ eid_t>
         local_ast_id_map_;
 
-    std::map<int64_t /* local anonymous struct id */,
+    util::flat_hash_map<int64_t /* local anonymous struct id */,
         std::tuple<std::string /* field name */, common::model::relationship_t,
             common::model::access_t>>
         anonymous_struct_relationships_;
@@ -0,0 +1,225 @@
+/**
+ * @file src/util/file_watcher.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "file_watcher.h"
+
+#include "util/util.h"
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(__linux)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <thread>
+#endif
+
+namespace clanguml::util {
+
+namespace {
+#if defined(__linux)
+// Period without any new events, after which collected changes are reported
+constexpr int kDebounceMs{200};
+constexpr std::uint32_t kWatchMask{
+    IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE};
+
+std::string last_error_message()
+{
+    return std::error_code{errno, std::generic_category()}.message();
+}
+
+int remaining_ms(std::chrono::steady_clock::time_point deadline)
+{
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now())
+            .count();
+
+    return remaining > 0 ? static_cast<int>(remaining) : 0;
+}
+#else
+constexpr auto kPollInterval = std::chrono::milliseconds{500};
+
+std::filesystem::file_time_type last_write_time(const std::string &path)
+{
+    std::error_code ec;
+    const auto result = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return std::filesystem::file_time_type::min();
+
+    return result;
+}
+#endif
+} // namespace
+
+#if defined(__linux)
+file_watcher::file_watcher()
+    : fd_{inotify_init1(IN_CLOEXEC)}
+{
+    if (fd_ < 0)
+        throw std::runtime_error(fmt::format(
+            "Failed to initialize inotify: {}", last_error_message()));
+}
+
+file_watcher::~file_watcher() { close(fd_); }
+
+void file_watcher::watch(const std::set<std::string> &paths)
+{
+    for (const auto &[wd, directory] : directories_)
+        inotify_rm_watch(fd_, wd);
+
+    directories_.clear();
+    paths_.clear();
+
+    std::set<std::filesystem::path> directories;
+    for (const auto &path : paths) {
+        const auto normalized = std::filesystem::path{path}.lexically_normal();
+        paths_.emplace(normalized.string());
+        directories.emplace(normalized.parent_path());
+    }
+
+    for (const auto &directory : directories) {
+        const auto wd = inotify_add_watch(fd_, directory.c_str(), kWatchMask);
+        if (wd < 0) {
+            LOG_WARN("Cannot watch directory {}: {}", directory.string(),
+                last_error_message());
+            continue;
+        }
+
+        directories_.emplace(wd, directory);
+    }
+
+    // Otherwise wait() would block forever
+    if (directories_.empty() && !paths_.empty())
+        throw std::runtime_error(fmt::format(
+            "Cannot watch any of the {} files for changes", paths_.size()));
+}
+
+std::set<std::string> file_watcher::wait(
+    std::optional<std::chrono::milliseconds> timeout)
+{
+    using std::chrono::steady_clock;
+
+    std::set<std::string> changed;
+
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+
+    const auto deadline =
+        steady_clock::now() + timeout.value_or(std::chrono::milliseconds{0});
+
+    while (true) {
+        pollfd pfd{fd_, POLLIN, 0};
+
+        // Block until the first relevant change, then keep collecting
+        // changes until no new events arrive for a while
+        auto poll_timeout = kDebounceMs;
+        if (changed.empty())
+            poll_timeout = timeout ? remaining_ms(deadline) : -1;
+
+        const auto res = poll(&pfd, 1, poll_timeout);
+        if (res < 0) {
+            if (errno == EINTR)
+                continue;
+
+            throw std::runtime_error(fmt::format(
+                "Failed to wait for file changes: {}", last_error_message()));
+        }
+
+        if (res == 0)
+            break;
+
+        const auto length = read(fd_, buffer.data(), buffer.size());
+        if (length <= 0)
+            continue;
+
+        for (auto offset = 0L; offset < length;) {
+            const auto *event =
+                reinterpret_cast<const inotify_event *>(&buffer[offset]);
+            offset += static_cast<long>(sizeof(inotify_event) + event->len);
+
+            // Some events were lost, so any of the files could have changed
+            if ((event->mask & IN_Q_OVERFLOW) != 0U) {
+                changed = paths_;
+                continue;
+            }
+
+            const auto directory = directories_.find(event->wd);
+            if (event->len == 0 || directory == directories_.end())
+                continue;
+
+            auto path = (directory->second / event->name).string();
+            if (paths_.count(path) > 0)
+                changed.emplace(std::move(path));
+        }
+    }
+
+    return changed;
+}
+#else
+file_watcher::file_watcher() = default;
+
+file_watcher::~file_watcher() = default;
+
+void file_watcher::watch(const std::set<std::string> &paths)
+{
+    paths_.clear();
+    timestamps_.clear();
+
+    for (const auto &path : paths) {
+        auto normalized = std::filesystem::path{path}.lexically_normal();
+        paths_.emplace(normalized.string());
+        timestamps_.emplace(normalized.string(), last_write_time(path));
+    }
+}
+
+std::set<std::string> file_watcher::wait(
+    std::optional<std::chrono::milliseconds> timeout)
+{
+    using std::chrono::steady_clock;
+
+    std::set<std::string> changed;
+
+    const auto deadline =
+        steady_clock::now() + timeout.value_or(std::chrono::milliseconds{0});
+
+    while (changed.empty()) {
+        if (timeout && steady_clock::now() >= deadline)
+            break;
+
+        std::this_thread::sleep_for(kPollInterval);
+
+        for (auto &[path, timestamp] : timestamps_) {
+            const auto current = last_write_time(path);
+            if (current != timestamp) {
+                timestamp = current;
+                changed.emplace(path);
+            }
+        }
+    }
+
+    return changed;
+}
+#endif
+
+} // namespace clanguml::util
@@ -0,0 +1,81 @@
+/**
+ * @file src/util/file_watcher.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace clanguml::util {
+
+/**
+ * @brief Waits for modifications of a set of files
+ *
+ * On Linux, the parent directories of the watched files are monitored using
+ * inotify, so that files replaced by editors (i.e. written to a temporary
+ * file and renamed) are also detected. On other platforms, modification
+ * times of the files are polled.
+ */
+class file_watcher {
+public:
+    file_watcher();
+
+    file_watcher(const file_watcher &) = delete;
+    file_watcher(file_watcher &&) = delete;
+    file_watcher &operator=(const file_watcher &) = delete;
+    file_watcher &operator=(file_watcher &&) = delete;
+
+    ~file_watcher();
+
+    /**
+     * @brief Replace the set of watched files
+     *
+     * Throws `std::runtime_error` if none of the files can be watched.
+     *
+     * @param paths Absolute paths of files to watch
+     */
+    void watch(const std::set<std::string> &paths);
+
+    /**
+     * @brief Wait until at least one of the watched files is modified
+     *
+     * Changes following each other in a short period of time (e.g. when
+     * saving multiple files at once) are reported together.
+     *
+     * @param timeout Maximum time to wait for the first change (optional)
+     * @return Normalized paths of modified files, empty if no file was
+     *         modified before the timeout
+     */
+    std::set<std::string> wait(
+        std::optional<std::chrono::milliseconds> timeout = {});
+
+private:
+    std::set<std::string> paths_;
+
+#if defined(__linux)
+    int fd_{-1};
+    std::map<int, std::filesystem::path> directories_;
+#else
+    std::map<std::string, std::filesystem::file_time_type> timestamps_;
+#endif
+};
+
+} // namespace clanguml::util
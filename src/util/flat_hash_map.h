@@ -0,0 +1,304 @@
+/**
+ * @file src/util/flat_hash_map.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace clanguml::util {
+
+/**
+ * @brief Open addressing hash map for integer and pointer keys
+ *
+ * Elements are stored in a single array and collisions are resolved using
+ * linear probing, so lookups do not chase pointers and inserting elements
+ * does not allocate, unless the map has to grow. It is meant for tables
+ * which are hit on every visited declaration or expression, such as
+ * mappings of Clang AST local ids.
+ *
+ * Only the subset of `std::unordered_map` interface needed by clang-uml is
+ * provided. Any insertion or erasure invalidates iterators and references.
+ *
+ * @tparam K Key type (integral or pointer type)
+ * @tparam V Value type
+ */
+template <typename K, typename V> class flat_hash_map {
+    static_assert(std::is_integral_v<K> || std::is_pointer_v<K>,
+        "flat_hash_map supports only integral and pointer keys");
+
+    using slot_t = std::optional<std::pair<K, V>>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+
+    template <typename SlotIt, typename Value> class iterator_base {
+    public:
+        iterator_base(SlotIt it, SlotIt end)
+            : it_{it}
+            , end_{end}
+        {
+            skip_empty();
+        }
+
+        Value &operator*() const { return **it_; }
+
+        Value *operator->() const { return &**it_; }
+
+        iterator_base &operator++()
+        {
+            ++it_;
+            skip_empty();
+            return *this;
+        }
+
+        bool operator==(const iterator_base &other) const
+        {
+            return it_ == other.it_;
+        }
+
+        bool operator!=(const iterator_base &other) const
+        {
+            return it_ != other.it_;
+        }
+
+    private:
+        friend class flat_hash_map;
+
+        void skip_empty()
+        {
+            while (it_ != end_ && !it_->has_value())
+                ++it_;
+        }
+
+        SlotIt it_;
+        SlotIt end_;
+    };
+
+    using iterator =
+        iterator_base<typename std::vector<slot_t>::iterator, value_type>;
+    using const_iterator = iterator_base<
+        typename std::vector<slot_t>::const_iterator, const value_type>;
+
+    flat_hash_map() = default;
+
+    iterator begin() { return {slots_.begin(), slots_.end()}; }
+
+    iterator end() { return {slots_.end(), slots_.end()}; }
+
+    const_iterator begin() const { return {slots_.begin(), slots_.end()}; }
+
+    const_iterator end() const { return {slots_.end(), slots_.end()}; }
+
+    std::size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Make sure that `n` elements can be stored without rehashing
+     *
+     * @param n Number of elements
+     */
+    void reserve(std::size_t n)
+    {
+        std::size_t capacity{kMinCapacity};
+        while (capacity * kMaxLoadNumerator < n * kMaxLoadDenominator)
+            capacity *= 2;
+
+        if (capacity > slots_.size())
+            rehash(capacity);
+    }
+
+    /**
+     * @brief Remove all elements, keeping the allocated capacity
+     */
+    void clear()
+    {
+        for (auto &slot : slots_)
+            slot.reset();
+        size_ = 0;
+    }
+
+    iterator find(const K &key)
+    {
+        const auto index = find_index(key);
+        if (!index)
+            return end();
+
+        return {slots_.begin() + *index, slots_.end()};
+    }
+
+    const_iterator find(const K &key) const
+    {
+        const auto index = find_index(key);
+        if (!index)
+            return end();
+
+        return {slots_.begin() + *index, slots_.end()};
+    }
+
+    std::size_t count(const K &key) const { return find_index(key) ? 1 : 0; }
+
+    V &at(const K &key)
+    {
+        const auto index = find_index(key);
+        if (!index)
+            throw std::out_of_range("flat_hash_map::at");
+
+        return slots_[*index]->second;
+    }
+
+    const V &at(const K &key) const
+    {
+        const auto index = find_index(key);
+        if (!index)
+            throw std::out_of_range("flat_hash_map::at");
+
+        return slots_[*index]->second;
+    }
+
+    V &operator[](const K &key) { return emplace(key, V{}).first->second; }
+
+    /**
+     * @brief Insert an element, if the key does not exist in the map yet
+     *
+     * @return Pair of iterator to the element with the key and a flag
+     *         whether the element was inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const K &key, Args &&...args)
+    {
+        if (auto index = find_index(key); index)
+            return {{slots_.begin() + *index, slots_.end()}, false};
+
+        if ((size_ + 1) * kMaxLoadDenominator >
+            slots_.size() * kMaxLoadNumerator)
+            rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+
+        auto index = bucket(key);
+        while (slots_[index].has_value())
+            index = (index + 1) & mask();
+
+        slots_[index].emplace(std::piecewise_construct,
+            std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        size_++;
+
+        return {{slots_.begin() + index, slots_.end()}, true};
+    }
+
+    /**
+     * @brief Remove element with the key, if exists
+     *
+     * @return Number of removed elements
+     */
+    std::size_t erase(const K &key)
+    {
+        auto index = find_index(key);
+        if (!index)
+            return 0;
+
+        // Backward shift deletion - move subsequent elements of the probe
+        // sequence into the freed slot, so that no tombstones are needed
+        auto hole = *index;
+        slots_[hole].reset();
+        size_--;
+
+        auto next = (hole + 1) & mask();
+        while (slots_[next].has_value()) {
+            const auto ideal = bucket(slots_[next]->first);
+            if (((next - ideal) & mask()) >= ((next - hole) & mask())) {
+                slots_[hole] = std::move(slots_[next]);
+                slots_[next].reset();
+                hole = next;
+            }
+            next = (next + 1) & mask();
+        }
+
+        return 1;
+    }
+
+private:
+    static constexpr std::size_t kMinCapacity{16};
+    // Maximum load factor of 3/4, linear probing degrades quickly above it
+    static constexpr std::size_t kMaxLoadNumerator{3};
+    static constexpr std::size_t kMaxLoadDenominator{4};
+
+    std::size_t mask() const { return slots_.size() - 1; }
+
+    std::size_t bucket(const K &key) const
+    {
+        std::uint64_t k{};
+        if constexpr (std::is_pointer_v<K>)
+            k = reinterpret_cast<std::uintptr_t>(key);
+        else
+            k = static_cast<std::uint64_t>(key);
+
+        // Fibonacci hashing spreads aligned pointers and sequential ids
+        // evenly over the slots
+        constexpr std::uint64_t kMultiplier{0x9E3779B97F4A7C15ULL};
+        return static_cast<std::size_t>((k * kMultiplier) >> 32U) & mask();
+    }
+
+    std::optional<std::size_t> find_index(const K &key) const
+    {
+        if (size_ == 0)
+            return {};
+
+        auto index = bucket(key);
+        while (slots_[index].has_value()) {
+            if (slots_[index]->first == key)
+                return index;
+            index = (index + 1) & mask();
+        }
+
+        return {};
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        assert((capacity & (capacity - 1)) == 0);
+
+        std::vector<slot_t> old(capacity);
+        old.swap(slots_);
+
+        for (auto &slot : old) {
+            if (!slot.has_value())
+                continue;
+
+            auto index = bucket(slot->first);
+            while (slots_[index].has_value())
+                index = (index + 1) & mask();
+
+            slots_[index] = std::move(slot);
+        }
+    }
+
+    std::vector<slot_t> slots_;
+    std::size_t size_{0};
+};
+
+} // namespace clanguml::util
@@ -0,0 +1,164 @@
+/**
+ * @file src/util/interned_string.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interned_string.h"
+
+#include <array>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+
+namespace clanguml::util {
+
+namespace {
+// The pool is split into shards to reduce lock contention between threads
+// generating different diagrams
+constexpr std::size_t kInternedStringPoolShards{16U};
+
+struct interned_string_pool_shard {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::atomic<std::size_t>> strings;
+};
+
+using interned_string_pool =
+    std::array<interned_string_pool_shard, kInternedStringPoolShards>;
+
+interned_string_pool &pool()
+{
+    // The pool is never destroyed, as interned strings can be released
+    // by destructors of other static objects
+    static auto *instance = new interned_string_pool{}; // NOLINT
+    return *instance;
+}
+
+interned_string_pool_shard &pool_shard(const std::string &s)
+{
+    return pool()[std::hash<std::string>{}(s) % kInternedStringPoolShards];
+}
+
+// Empty strings are not stored in the pool and are not reference counted
+std::pair<const std::string, std::atomic<std::size_t>> &empty_entry()
+{
+    static std::pair<const std::string, std::atomic<std::size_t>> empty{
+        std::string{}, 0};
+    return empty;
+}
+} // namespace
+
+interned_string::interned_string()
+    : value_{&empty_entry()}
+{
+}
+
+interned_string::interned_string(const std::string &s)
+    : value_{intern(s)}
+{
+}
+
+interned_string::interned_string(const char *s)
+    : value_{intern(std::string{s})}
+{
+}
+
+interned_string::interned_string(const interned_string &other)
+    : value_{other.value_}
+{
+    acquire(value_);
+}
+
+interned_string::interned_string(interned_string &&other) noexcept
+    : value_{other.value_}
+{
+    other.value_ = &empty_entry();
+}
+
+interned_string &interned_string::operator=(const interned_string &other)
+{
+    if (value_ != other.value_) {
+        acquire(other.value_);
+        release(value_);
+        value_ = other.value_;
+    }
+
+    return *this;
+}
+
+interned_string &interned_string::operator=(interned_string &&other) noexcept
+{
+    std::swap(value_, other.value_);
+
+    return *this;
+}
+
+interned_string::~interned_string() { release(value_); }
+
+std::size_t interned_string::pool_size()
+{
+    auto &p = pool();
+
+    return std::accumulate(p.begin(), p.end(), std::size_t{0},
+        [](std::size_t count, interned_string_pool_shard &shard) {
+            std::lock_guard<std::mutex> l(shard.mutex);
+            return count + shard.strings.size();
+        });
+}
+
+interned_string::entry *interned_string::intern(const std::string &s)
+{
+    if (s.empty())
+        return &empty_entry();
+
+    auto &shard = pool_shard(s);
+
+    std::lock_guard<std::mutex> l(shard.mutex);
+
+    // Elements of std::unordered_map are never moved in memory
+    auto &e = *shard.strings.try_emplace(s, 0).first;
+    e.second++;
+
+    return &e;
+}
+
+void interned_string::acquire(entry *e)
+{
+    if (e != &empty_entry())
+        e->second++;
+}
+
+void interned_string::release(entry *e)
+{
+    if (e == &empty_entry())
+        return;
+
+    // Only the last reference has to be released under the shard lock, as
+    // the string can be interned again concurrently
+    auto count = e->second.load();
+    while (count > 1) {
+        if (e->second.compare_exchange_weak(count, count - 1))
+            return;
+    }
+
+    auto &shard = pool_shard(e->first);
+
+    std::lock_guard<std::mutex> l(shard.mutex);
+
+    if (--e->second == 0)
+        shard.strings.erase(shard.strings.find(e->first));
+}
+
+} // namespace clanguml::util
@@ -0,0 +1,100 @@
+/**
+ * @file src/util/interned_string.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace clanguml::util {
+
+/**
+ * @brief Immutable string stored in a process wide pool of unique strings
+ *
+ * Each unique string value is stored only once, and instances of this class
+ * only hold a pointer to the pooled value. This makes copying interned
+ * strings cheap and comparing them trivial, which is useful for values
+ * repeated in large number of model elements, such as source file paths or
+ * message names.
+ *
+ * Pooled strings are reference counted, and are released from the pool
+ * when the last instance referring to them is destroyed. This way models of
+ * diagrams regenerated in watch or daemon mode do not leave their strings
+ * behind in the pool. The reference count is atomic, so copying the same
+ * string in many threads at once contends on it.
+ */
+class interned_string {
+public:
+    interned_string();
+
+    interned_string(const std::string &s);
+
+    interned_string(const char *s);
+
+    interned_string(const interned_string &other);
+
+    interned_string(interned_string &&other) noexcept;
+
+    interned_string &operator=(const interned_string &other);
+
+    interned_string &operator=(interned_string &&other) noexcept;
+
+    ~interned_string();
+
+    /**
+     * @brief Get reference to the pooled string value
+     *
+     * @return Reference to the string value
+     */
+    const std::string &str() const { return value_->first; }
+
+    operator const std::string &() const { return value_->first; }
+
+    bool empty() const { return value_->first.empty(); }
+
+    /**
+     * @brief Get number of unique strings currently stored in the pool
+     *
+     * @return Number of pooled strings
+     */
+    static std::size_t pool_size();
+
+    friend bool operator==(const interned_string &l, const interned_string &r)
+    {
+        return l.value_ == r.value_;
+    }
+
+    friend bool operator!=(const interned_string &l, const interned_string &r)
+    {
+        return l.value_ != r.value_;
+    }
+
+private:
+    using entry = std::pair<const std::string, std::atomic<std::size_t>>;
+
+    static entry *intern(const std::string &s);
+
+    static void acquire(entry *e);
+
+    static void release(entry *e);
+
+    entry *value_;
+};
+
+} // namespace clanguml::util
@@ -18,6 +18,8 @@
 
 #include "thread_pool_executor.h"
 
+#include "trace.h"
+
 namespace clanguml::util {
 
 thread_pool_executor::thread_pool_executor(unsigned int pool_size)
@@ -63,6 +65,7 @@ void thread_pool_executor::worker()
         while (!done_) {
             auto task = get();
 
+            trace_scope trace{"executor", "task"};
             task();
         }
     }
@@ -0,0 +1,136 @@
+/**
+ * @file src/util/trace.cc
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace.h"
+
+#include "util/util.h"
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+
+namespace clanguml::util {
+
+namespace {
+double to_us(tracer::clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+} // namespace
+
+tracer &tracer::instance()
+{
+    static tracer instance;
+    return instance;
+}
+
+void tracer::start(const std::filesystem::path &path)
+{
+    std::lock_guard<std::mutex> l{mutex_};
+
+    path_ = path;
+    origin_ = clock::now();
+    events_.clear();
+    thread_indexes_.clear();
+
+    // The thread starting the trace is displayed as the main thread
+    thread_index(std::this_thread::get_id());
+
+    enabled_ = true;
+}
+
+void tracer::stop()
+{
+    if (!enabled_.exchange(false))
+        return;
+
+    std::lock_guard<std::mutex> l{mutex_};
+
+    nlohmann::json trace_events = nlohmann::json::array();
+
+    for (const auto &[id, index] : thread_indexes_) {
+        trace_events.push_back({{"name", "thread_name"}, {"ph", "M"},
+            {"pid", 1}, {"tid", index},
+            {"args",
+                {{"name",
+                    index == 0 ? std::string{"main"}
+                               : fmt::format("thread {}", index)}}}});
+    }
+
+    for (const auto &e : events_) {
+        trace_events.push_back({{"name", e.name}, {"cat", e.category},
+            {"ph", "X"}, {"pid", 1}, {"tid", e.tid}, {"ts", e.ts_us},
+            {"dur", e.dur_us}});
+    }
+
+    nlohmann::json trace;
+    trace["traceEvents"] = std::move(trace_events);
+    trace["displayTimeUnit"] = "ms";
+
+    std::ofstream ofs;
+    ofs.open(path_, std::ofstream::out | std::ofstream::trunc);
+    ofs << trace.dump() << '\n';
+    ofs.close();
+
+    LOG_INFO("Written {} trace events to {}", events_.size(), path_.string());
+
+    events_.clear();
+}
+
+void tracer::add_event(const char *category, std::string name,
+    clock::time_point start, clock::time_point end)
+{
+    if (!enabled())
+        return;
+
+    std::lock_guard<std::mutex> l{mutex_};
+
+    events_.push_back({category, std::move(name),
+        thread_index(std::this_thread::get_id()), to_us(start - origin_),
+        to_us(end - start)});
+}
+
+unsigned tracer::thread_index(std::thread::id id)
+{
+    auto it = thread_indexes_.find(id);
+    if (it == thread_indexes_.end())
+        it = thread_indexes_
+                 .emplace(id, static_cast<unsigned>(thread_indexes_.size()))
+                 .first;
+
+    return it->second;
+}
+
+trace_scope::trace_scope(const char *category, std::string name)
+    : category_{category}
+    , active_{tracer::instance().enabled()}
+{
+    if (active_) {
+        name_ = std::move(name);
+        start_ = tracer::clock::now();
+    }
+}
+
+trace_scope::~trace_scope()
+{
+    if (active_)
+        tracer::instance().add_event(
+            category_, std::move(name_), start_, tracer::clock::now());
+}
+
+} // namespace clanguml::util
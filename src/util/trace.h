@@ -0,0 +1,119 @@
+/**
+ * @file src/util/trace.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace clanguml::util {
+
+/**
+ * @brief Process-wide collector of Chrome trace events
+ *
+ * When enabled with `--trace-file`, events recorded from any thread are
+ * collected in memory and written at the end of the run in the Chrome
+ * trace event format, which can be opened in `chrome://tracing` or
+ * [Perfetto](https://ui.perfetto.dev). Each thread is displayed on a
+ * separate track.
+ */
+class tracer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Get the global tracer instance
+     */
+    static tracer &instance();
+
+    /**
+     * @brief Start collecting trace events
+     *
+     * @param path Path to the trace file written by stop()
+     */
+    void start(const std::filesystem::path &path);
+
+    /**
+     * @brief Stop collecting trace events and write them to the trace file
+     */
+    void stop();
+
+    /**
+     * @brief Check whether trace events are being collected
+     */
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Record a complete event on the current thread's track
+     *
+     * @param category Event category, e.g. `clang` or `generator`
+     * @param name Name of the event
+     * @param start Start of the event
+     * @param end End of the event
+     */
+    void add_event(const char *category, std::string name,
+        clock::time_point start, clock::time_point end);
+
+private:
+    struct event {
+        const char *category;
+        std::string name;
+        unsigned tid;
+        double ts_us;
+        double dur_us;
+    };
+
+    unsigned thread_index(std::thread::id id);
+
+    std::atomic_bool enabled_{false};
+    std::mutex mutex_;
+    std::filesystem::path path_;
+    clock::time_point origin_;
+    std::vector<event> events_;
+    std::map<std::thread::id, unsigned> thread_indexes_;
+};
+
+/**
+ * @brief RAII helper recording a trace event spanning its lifetime
+ *
+ * If tracing is disabled, the scope does nothing.
+ */
+class trace_scope {
+public:
+    trace_scope(const char *category, std::string name);
+
+    trace_scope(const trace_scope &) = delete;
+    trace_scope(trace_scope &&) = delete;
+    trace_scope &operator=(const trace_scope &) = delete;
+    trace_scope &operator=(trace_scope &&) = delete;
+
+    ~trace_scope();
+
+private:
+    const char *category_;
+    std::string name_;
+    bool active_;
+    tracer::clock::time_point start_;
+};
+
+} // namespace clanguml::util
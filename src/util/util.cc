@@ -19,7 +19,11 @@
 
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <fstream>
+#include <mutex>
 #include <regex>
+#include <unordered_map>
 #if __has_include(<sys/utsname.h>)
 #include <sys/utsname.h>
 #endif
@@ -28,6 +32,40 @@ namespace clanguml::util {
 
 static const auto WHITESPACE = " \n\r\t\f\v";
 
+namespace detail {
+std::atomic<spdlog::logger *> cached_logger{nullptr};
+
+namespace {
+std::mutex logger_mutex;
+// Keeps the cached logger alive, even if it is dropped from the registry
+std::shared_ptr<spdlog::logger> logger_holder;
+} // namespace
+
+spdlog::logger *find_logger()
+{
+    std::lock_guard<std::mutex> l{logger_mutex};
+
+    if (!logger_holder)
+        logger_holder = spdlog::get("clanguml-logger");
+
+    cached_logger.store(logger_holder.get(), std::memory_order_release);
+
+    return logger_holder.get();
+}
+} // namespace detail
+
+void register_logger(std::shared_ptr<spdlog::logger> logger)
+{
+    std::lock_guard<std::mutex> l{detail::logger_mutex};
+
+    spdlog::drop("clanguml-logger");
+    spdlog::register_logger(logger);
+
+    detail::logger_holder = std::move(logger);
+    detail::cached_logger.store(
+        detail::logger_holder.get(), std::memory_order_release);
+}
+
 namespace {
 class pipe_t {
 public:
@@ -306,6 +344,55 @@ std::vector<std::string> split_isspace(std::string str)
     return result;
 }
 
+std::vector<std::string> split_command_line(std::string_view command)
+{
+    std::vector<std::string> result;
+    std::optional<std::string> argument;
+    char quote{0};
+
+    for (auto it = command.begin(); it != command.end(); it++) {
+        const auto c = *it;
+
+        if (quote == '\'') {
+            if (c == '\'')
+                quote = 0;
+            else
+                argument->push_back(c);
+        }
+        else if (quote == '"') {
+            if (c == '"')
+                quote = 0;
+            else if (c == '\\' && std::next(it) != command.end() &&
+                (*std::next(it) == '"' || *std::next(it) == '\\' ||
+                    *std::next(it) == '$'))
+                argument->push_back(*++it);
+            else
+                argument->push_back(c);
+        }
+        else if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+            if (argument)
+                result.emplace_back(std::move(*argument));
+            argument.reset();
+        }
+        else {
+            if (!argument)
+                argument.emplace();
+
+            if (c == '\'' || c == '"')
+                quote = c;
+            else if (c == '\\' && std::next(it) != command.end())
+                argument->push_back(*++it);
+            else
+                argument->push_back(c);
+        }
+    }
+
+    if (argument)
+        result.emplace_back(std::move(*argument));
+
+    return result;
+}
+
 std::string join(
     const std::vector<std::string> &toks, std::string_view delimiter)
 {
@@ -365,6 +452,67 @@ bool replace_all(std::string &input, const std::string &pattern,
     return replaced;
 }
 
+std::optional<std::string> expand_command_template(
+    const std::string &command_template, const std::vector<std::string> &values)
+{
+    constexpr auto kPlaceholder = "{}";
+    constexpr auto kWhitespace = " \t";
+
+    if (values.size() == 1) {
+        auto result = command_template;
+        replace_all(result, kPlaceholder, values.front());
+        return result;
+    }
+
+    const auto pos = command_template.find(kPlaceholder);
+    if (pos == std::string::npos ||
+        command_template.find(kPlaceholder, pos + 1) != std::string::npos)
+        return {};
+
+    // Find the beginning of the argument containing the placeholder,
+    // skipping whitespace within quotes like split_command_line()
+    std::size_t argument_begin{0};
+    char quote{0};
+    for (std::size_t i = 0; i < pos; i++) {
+        const auto c = command_template[i];
+
+        if (quote != 0) {
+            if (c == quote)
+                quote = 0;
+            else if (quote == '"' && c == '\\')
+                i++;
+        }
+        else if (std::isspace(static_cast<unsigned char>(c)) != 0)
+            argument_begin = i + 1;
+        else if (c == '\'' || c == '"')
+            quote = c;
+        else if (c == '\\')
+            i++;
+    }
+
+    auto argument_end = command_template.find_first_of(kWhitespace, pos);
+    if (argument_end == std::string::npos)
+        argument_end = command_template.size();
+
+    const auto argument =
+        command_template.substr(argument_begin, argument_end - argument_begin);
+
+    // Quoted or escaped arguments cannot be repeated by substitution, e.g.
+    // `"out dir/{}.puml"`, so such templates are expanded for single values
+    if (quote != 0 || argument.find_first_of("'\"\\") != std::string::npos)
+        return {};
+
+    std::vector<std::string> arguments;
+    for (const auto &value : values) {
+        auto expanded_argument = argument;
+        replace_all(expanded_argument, kPlaceholder, value);
+        arguments.emplace_back(std::move(expanded_argument));
+    }
+
+    return fmt::format("{}{}{}", command_template.substr(0, argument_begin),
+        fmt::join(arguments, " "), command_template.substr(argument_end));
+}
+
 template <>
 bool starts_with(
     const std::filesystem::path &path, const std::filesystem::path &prefix)
@@ -410,6 +558,131 @@ std::size_t hash_seed(std::size_t seed)
     return kSeedStart + (seed << kSeedShiftFirst) + (seed >> kSeedShiftSecond);
 }
 
+namespace {
+constexpr std::uint64_t kXXH64Prime1{0x9E3779B185EBCA87ULL};
+constexpr std::uint64_t kXXH64Prime2{0xC2B2AE3D27D4EB4FULL};
+constexpr std::uint64_t kXXH64Prime3{0x165667B19E3779F9ULL};
+constexpr std::uint64_t kXXH64Prime4{0x85EBCA77C2B2AE63ULL};
+constexpr std::uint64_t kXXH64Prime5{0x27D4EB2F165667C5ULL};
+
+constexpr std::uint64_t rotl64(std::uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+// Read bytes in little-endian order regardless of the platform
+template <typename T> T read_le(const unsigned char *p)
+{
+    T result{0};
+    for (auto i = 0U; i < sizeof(T); i++)
+        result |= static_cast<T>(p[i]) << (8 * i);
+    return result;
+}
+
+std::uint64_t xxh64_round(std::uint64_t acc, std::uint64_t input)
+{
+    acc += input * kXXH64Prime2;
+    acc = rotl64(acc, 31);
+    return acc * kXXH64Prime1;
+}
+
+std::uint64_t xxh64_merge_round(std::uint64_t acc, std::uint64_t val)
+{
+    acc ^= xxh64_round(0, val);
+    return acc * kXXH64Prime1 + kXXH64Prime4;
+}
+} // namespace
+
+std::uint64_t stable_hash(std::string_view s, std::uint64_t seed)
+{
+    const auto *p = reinterpret_cast<const unsigned char *>(s.data());
+    const auto *const end = p + s.size();
+
+    std::uint64_t h{0};
+
+    if (s.size() >= 32) {
+        std::uint64_t v1 = seed + kXXH64Prime1 + kXXH64Prime2;
+        std::uint64_t v2 = seed + kXXH64Prime2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - kXXH64Prime1;
+
+        for (; end - p >= 32; p += 32) {
+            v1 = xxh64_round(v1, read_le<std::uint64_t>(p));
+            v2 = xxh64_round(v2, read_le<std::uint64_t>(p + 8));
+            v3 = xxh64_round(v3, read_le<std::uint64_t>(p + 16));
+            v4 = xxh64_round(v4, read_le<std::uint64_t>(p + 24));
+        }
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh64_merge_round(h, v1);
+        h = xxh64_merge_round(h, v2);
+        h = xxh64_merge_round(h, v3);
+        h = xxh64_merge_round(h, v4);
+    }
+    else {
+        h = seed + kXXH64Prime5;
+    }
+
+    h += static_cast<std::uint64_t>(s.size());
+
+    for (; end - p >= 8; p += 8) {
+        h ^= xxh64_round(0, read_le<std::uint64_t>(p));
+        h = rotl64(h, 27) * kXXH64Prime1 + kXXH64Prime4;
+    }
+
+    if (end - p >= 4) {
+        h ^= static_cast<std::uint64_t>(read_le<std::uint32_t>(p)) *
+            kXXH64Prime1;
+        h = rotl64(h, 23) * kXXH64Prime2 + kXXH64Prime3;
+        p += 4;
+    }
+
+    for (; p < end; p++) {
+        h ^= static_cast<std::uint64_t>(*p) * kXXH64Prime5;
+        h = rotl64(h, 11) * kXXH64Prime1;
+    }
+
+    h ^= h >> 33;
+    h *= kXXH64Prime2;
+    h ^= h >> 29;
+    h *= kXXH64Prime3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+bool file_content_equals(
+    const std::filesystem::path &path, std::string_view content)
+{
+    // The file is read in text mode, like it is written, so on Windows it
+    // is larger than its contents due to CRLF line endings
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec || size < content.size())
+        return false;
+
+    std::ifstream ifs{path};
+    if (!ifs)
+        return false;
+
+    constexpr std::size_t kChunkSize{16 * 1024};
+    std::array<char, kChunkSize> chunk{};
+
+    std::size_t offset{0};
+    while (offset < content.size()) {
+        const auto count = std::min(kChunkSize, content.size() - offset);
+        if (!ifs.read(chunk.data(), static_cast<std::streamsize>(count)))
+            return false;
+
+        if (content.compare(offset, count, chunk.data(), count) != 0)
+            return false;
+
+        offset += count;
+    }
+
+    return ifs.peek() == std::ifstream::traits_type::eof();
+}
+
 std::string path_to_url(const std::filesystem::path &p)
 {
     std::vector<std::string> path_tokens;
@@ -451,6 +724,39 @@ std::filesystem::path ensure_path_is_absolute(
     return result;
 }
 
+namespace {
+std::mutex weakly_canonical_cache_mutex;
+std::unordered_map<std::string, std::filesystem::path> weakly_canonical_cache;
+} // namespace
+
+std::filesystem::path cached_weakly_canonical(const std::filesystem::path &p)
+{
+    auto &cache_mutex = weakly_canonical_cache_mutex;
+    auto &cache = weakly_canonical_cache;
+
+    if (!p.is_absolute())
+        return std::filesystem::weakly_canonical(p);
+
+    {
+        std::lock_guard<std::mutex> l{cache_mutex};
+        if (auto it = cache.find(p.string()); it != cache.end())
+            return it->second;
+    }
+
+    auto result = std::filesystem::weakly_canonical(p);
+
+    std::lock_guard<std::mutex> l{cache_mutex};
+    cache.emplace(p.string(), result);
+
+    return result;
+}
+
+void clear_weakly_canonical_cache()
+{
+    std::lock_guard<std::mutex> l{weakly_canonical_cache_mutex};
+    weakly_canonical_cache.clear();
+}
+
 bool is_relative_to(
     const std::filesystem::path &child, const std::filesystem::path &parent)
 {
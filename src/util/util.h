@@ -21,36 +21,42 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
+// Logging macros check the log level before evaluating their arguments, so
+// that disabled debug and trace messages have negligible cost. The format
+// string must be a string literal.
+#define LOG_AT_LEVEL_(level__, fmt__, ...)                                     \
+    do {                                                                       \
+        auto *clanguml_logger__ = ::clanguml::util::logger();                  \
+        if (clanguml_logger__->should_log(level__))                            \
+            clanguml_logger__->log(level__, "[{}:{}] " fmt__, FILENAME_,       \
+                __LINE__, ##__VA_ARGS__);                                      \
+    } while (false)
+
 #define LOG_ERROR(fmt__, ...)                                                  \
-    spdlog::get("clanguml-logger")                                             \
-        ->error(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,      \
-            __LINE__, ##__VA_ARGS__)
+    LOG_AT_LEVEL_(spdlog::level::err, fmt__, ##__VA_ARGS__)
 
 #define LOG_WARN(fmt__, ...)                                                   \
-    spdlog::get("clanguml-logger")                                             \
-        ->warn(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,       \
-            __LINE__, ##__VA_ARGS__)
+    LOG_AT_LEVEL_(spdlog::level::warn, fmt__, ##__VA_ARGS__)
 
 #define LOG_INFO(fmt__, ...)                                                   \
-    spdlog::get("clanguml-logger")                                             \
-        ->info(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,       \
-            __LINE__, ##__VA_ARGS__)
+    LOG_AT_LEVEL_(spdlog::level::info, fmt__, ##__VA_ARGS__)
 
 #define LOG_DBG(fmt__, ...)                                                    \
-    spdlog::get("clanguml-logger")                                             \
-        ->debug(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,      \
-            __LINE__, ##__VA_ARGS__)
+    LOG_AT_LEVEL_(spdlog::level::debug, fmt__, ##__VA_ARGS__)
 
 #define LOG_TRACE(fmt__, ...)                                                  \
-    spdlog::get("clanguml-logger")                                             \
-        ->trace(fmt::runtime(std::string("[{}:{}] ") + fmt__), FILENAME_,      \
-            __LINE__, ##__VA_ARGS__)
+    LOG_AT_LEVEL_(spdlog::level::trace, fmt__, ##__VA_ARGS__)
 
 namespace clanguml::util {
 
@@ -59,6 +65,36 @@ namespace clanguml::util {
 
 constexpr unsigned kDefaultMessageCommentWidth{25U};
 
+namespace detail {
+extern std::atomic<spdlog::logger *> cached_logger;
+
+spdlog::logger *find_logger();
+} // namespace detail
+
+/**
+ * @brief Get the clang-uml logger
+ *
+ * The logger is looked up in the spdlog registry only once and then cached,
+ * as the registry lookup requires locking a mutex.
+ *
+ * @return Pointer to the logger
+ */
+inline spdlog::logger *logger()
+{
+    auto *result = detail::cached_logger.load(std::memory_order_acquire);
+
+    return result != nullptr ? result : detail::find_logger();
+}
+
+/**
+ * @brief Replace the clang-uml logger in the spdlog registry and the cache
+ *
+ * This must not be called while other threads are logging.
+ *
+ * @param logger New logger instance named `clanguml-logger`
+ */
+void register_logger(std::shared_ptr<spdlog::logger> logger);
+
 /**
  * @brief Left trim a string
  *
@@ -189,6 +225,20 @@ std::vector<std::string> split(
 
 std::vector<std::string> split_isspace(std::string str);
 
+/**
+ * @brief Split a command line into arguments like a POSIX shell
+ *
+ * Arguments are separated by unquoted whitespace. Single and double quotes
+ * are removed, and backslash escapes the next character outside of quotes
+ * and `"`, `\` and `$` within double quotes, e.g.
+ * `plantuml -tsvg "diagrams/{}.puml"` is split into `plantuml`, `-tsvg`
+ * and `diagrams/{}.puml`.
+ *
+ * @param command Command line
+ * @return Command line arguments
+ */
+std::vector<std::string> split_command_line(std::string_view command);
+
 /**
  * @brief Remove and erase elements from a vector
  *
@@ -265,6 +315,23 @@ bool find_element_alias(
 bool replace_all(std::string &input, const std::string &pattern,
     const std::string &replace_with);
 
+/**
+ * @brief Expand command template with `{}` placeholder for multiple values
+ *
+ * The whitespace delimited argument containing the placeholder is repeated
+ * for each value, e.g. `plantuml -tsvg {}.puml` for values `a` and `b`
+ * becomes `plantuml -tsvg a.puml b.puml`.
+ *
+ * @param command_template Command template
+ * @param values Values to substitute for the placeholder
+ * @return Expanded command or empty optional, if more than one value was
+ *         provided and the template contains more than one placeholder or
+ *         the argument containing the placeholder is quoted or escaped
+ */
+std::optional<std::string> expand_command_template(
+    const std::string &command_template,
+    const std::vector<std::string> &values);
+
 /**
  * @brief Appends a vector to a vector.
  *
@@ -422,6 +489,32 @@ template <typename F> void _if(const bool condition, F &&func)
  */
 std::size_t hash_seed(std::size_t seed);
 
+/**
+ * @brief Calculate a stable 64-bit hash of a string
+ *
+ * Unlike `std::hash`, the result does not depend on the standard library,
+ * compiler or platform (it implements the XXH64 algorithm), so it can be used
+ * for identifiers which are persisted or compared between processes.
+ *
+ * @param s Input string
+ * @param seed Hash seed
+ * @return 64-bit hash value
+ */
+std::uint64_t stable_hash(std::string_view s, std::uint64_t seed = 0);
+
+/**
+ * @brief Check if file exists and has exactly the specified contents
+ *
+ * The file is read in text mode, in chunks, without reading it whole into
+ * memory.
+ *
+ * @param path Path to the file
+ * @param content Expected file contents
+ * @return True, if the file contents are equal to `content`
+ */
+bool file_content_equals(
+    const std::filesystem::path &path, std::string_view content);
+
 /**
  * @brief Convert filesystem path to url path
  *
@@ -446,6 +539,26 @@ std::string path_to_url(const std::filesystem::path &p);
 std::filesystem::path ensure_path_is_absolute(const std::filesystem::path &p,
     const std::filesystem::path &root = std::filesystem::current_path());
 
+/**
+ * @brief Return weakly canonical form of an absolute path
+ *
+ * Results are cached until clear_weakly_canonical_cache() is called, as
+ * canonicalization requires a filesystem lookup of each path component.
+ * Relative paths depend on the current directory, and are not cached.
+ *
+ * @param p Path to canonicalize
+ * @return Weakly canonical path
+ */
+std::filesystem::path cached_weakly_canonical(const std::filesystem::path &p);
+
+/**
+ * @brief Drop all paths cached by cached_weakly_canonical()
+ *
+ * Has to be called when symbolic links or directories may have changed,
+ * e.g. before regenerating diagrams with a reloaded configuration.
+ */
+void clear_weakly_canonical_cache();
+
 /**
  * @brief Check if a given path is relative to another path.
  *
@@ -0,0 +1,42 @@
+#include <vector>
+
+namespace clanguml {
+namespace t90002 {
+
+/// \brief This is class A
+class A {
+public:
+    /// Abstract foo
+    virtual int foo() = 0;
+};
+
+/// \brief This is class B
+class B : public A {
+public:
+    int foo() override { return 1; }
+};
+
+/// This is class C
+class C {
+public:
+    /// Sum results of all the A pointers
+    int bar()
+    {
+        int result{};
+        for (auto *a : as)
+            result += a->foo();
+        return result + b.foo();
+    }
+
+private:
+    B b;
+    std::vector<A *> as;
+};
+
+int tmain()
+{
+    C c;
+    return c.bar();
+}
+} // namespace t90002
+} // namespace clanguml
@@ -0,0 +1,63 @@
+/**
+ * tests/t90002/test_case.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+TEST_CASE("t90002")
+{
+    using namespace clanguml::test;
+    using clanguml::common::generator_type_t;
+
+    auto [config, db] = load_config("t90002");
+
+    const temporary_directory temp{"clanguml_t90002"};
+    const auto &output_directory = temp.path;
+
+    const std::vector<std::pair<generator_type_t, std::string>> generators{
+        {generator_type_t::plantuml, "puml"}, {generator_type_t::json, "json"},
+        {generator_type_t::mermaid, "mmd"}};
+
+    clanguml::cli::runtime_config runtime_config;
+    runtime_config.output_directory = output_directory.string();
+    for (const auto &[generator_type, extension] : generators)
+        runtime_config.generators.push_back(generator_type);
+
+    for (const auto *name : {"t90002_class", "t90002_sequence"}) {
+        auto diagram = config.diagrams[name];
+        const auto translation_units = diagram->get_translation_units();
+
+        // All output formats are generated in parallel from a single model
+        const auto written = clanguml::common::generators::generate_diagram(
+            name, diagram, *db, translation_units, runtime_config, {});
+
+        REQUIRE(written == runtime_config.generators);
+
+        // Generate each output format on its own from a separate model
+        auto model = clanguml::common::generators::generate_diagram_model(
+            diagram, *db, translation_units);
+
+        for (const auto &[generator_type, extension] : generators) {
+            std::ifstream ifs{
+                output_directory / fmt::format("{}.{}", name, extension)};
+            std::stringstream parallel_output;
+            parallel_output << ifs.rdbuf();
+
+            CHECK(parallel_output.str() ==
+                clanguml::common::generators::generate_diagram_output(
+                    generator_type, *diagram, *model));
+        }
+    }
+}
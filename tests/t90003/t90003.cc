@@ -0,0 +1,15 @@
+namespace clanguml {
+namespace t90003 {
+
+class A {
+public:
+    int foo() { return 1; }
+};
+
+class B {
+public:
+    A a;
+};
+
+} // namespace t90003
+} // namespace clanguml
@@ -0,0 +1,182 @@
+/**
+ * tests/t90003/test_case.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+TEST_CASE("t90003")
+{
+    using namespace clanguml::test;
+    using clanguml::common::generator_type_t;
+
+    auto [config, db] = load_config("t90003");
+
+    std::map<std::string, std::vector<std::string>> translation_units_map;
+    for (const auto &[name, diagram] : config.diagrams)
+        translation_units_map[name] = diagram->get_translation_units();
+
+    const auto source = translation_units_map["t90003_class"].at(0);
+
+    clanguml::cli::runtime_config runtime_config;
+    runtime_config.generators.push_back(generator_type_t::plantuml);
+
+    clanguml::common::generators::diagram_server server{
+        config, *db, runtime_config, translation_units_map};
+
+    auto response = server.handle_request({{"command", "list"}});
+    REQUIRE(response["status"] == "ok");
+    CHECK(response["diagrams"].size() == 2);
+    CHECK(response["diagrams"][0]["name"] == "t90003_class");
+    CHECK(response["diagrams"][0]["type"] == "class");
+
+    for (const auto &request : {nlohmann::json{{"command", "unknown"}},
+             nlohmann::json{{"command", "generate"}},
+             nlohmann::json{{"diagram", "missing"}},
+             nlohmann::json{{"diagram", "t90003_empty"}},
+             nlohmann::json{
+                 {"diagram", "t90003_class"}, {"generator", "unknown"}}}) {
+        response = server.handle_request(request);
+        CHECK(response["status"] == "error");
+        CHECK(response.contains("error"));
+    }
+
+    // The first request generates the model, which is reused afterwards
+    response = server.handle_request({{"diagram", "t90003_class"}});
+    REQUIRE(response["status"] == "ok");
+    CHECK(response["generator"] == "plantuml");
+    CHECK_FALSE(response["cached"].get<bool>());
+
+    const auto output = response["output"].get<std::string>();
+    CHECK(output.find("@startuml") != std::string::npos);
+
+    response = server.handle_request({{"diagram", "t90003_class"}});
+    CHECK(response["cached"].get<bool>());
+    CHECK(response["output"] == output);
+
+    response = server.handle_request(
+        {{"diagram", "t90003_class"}, {"generator", "json"}});
+    REQUIRE(response["status"] == "ok");
+    CHECK(response["generator"] == "json");
+    CHECK(response["cached"].get<bool>());
+
+    // Modifying a source file invalidates the cached model
+    {
+        const last_write_time_guard guard{source};
+        std::filesystem::last_write_time(
+            source, guard.last_write_time + std::chrono::hours{1});
+
+        response = server.handle_request({{"diagram", "t90003_class"}});
+    }
+
+    CHECK_FALSE(response["cached"].get<bool>());
+    CHECK(response["output"] == output);
+
+    response = server.handle_request({{"command", "shutdown"}});
+    CHECK(response["status"] == "ok");
+}
+
+#if !defined(_WIN32)
+TEST_CASE("t90003_limits")
+{
+    using namespace clanguml::test;
+    using clanguml::common::generators::diagram_server;
+
+    auto [config, db] = load_config("t90003");
+
+    clanguml::cli::runtime_config runtime_config;
+    runtime_config.thread_count = 1;
+
+    diagram_server server{config, *db, runtime_config, {}};
+
+    const auto socket_path =
+        (std::filesystem::temp_directory_path() / "clanguml_t90003.sock")
+            .string();
+
+    std::thread server_thread{[&]() { server.run(socket_path); }};
+
+    const auto connect_client = [&]() {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::copy(socket_path.begin(), socket_path.end(), address.sun_path);
+
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        for (auto attempt = 0; attempt < 50; attempt++) {
+            if (connect(fd, reinterpret_cast<sockaddr *>(&address),
+                    sizeof(address)) == 0)
+                return fd;
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        }
+        close(fd);
+        return -1;
+    };
+
+    const auto request = [](int fd, const std::string &line) {
+        std::string data = line;
+        while (!data.empty()) {
+            const auto res = write(fd, data.data(), data.size());
+            if (res <= 0)
+                break;
+            data.erase(0, static_cast<std::size_t>(res));
+        }
+
+        std::string response;
+        char c{};
+        while (read(fd, &c, 1) == 1 && c != '\n')
+            response += c;
+
+        return response.empty() ? nlohmann::json{}
+                                : nlohmann::json::parse(response);
+    };
+
+    // Requests without a newline cannot grow beyond the limit
+    int fd = connect_client();
+    REQUIRE(fd >= 0);
+    auto response = request(
+        fd, std::string(diagram_server::kMaxRequestLength + 1, ' '));
+    CHECK(response["status"] == "error");
+    close(fd);
+
+    // Clients above the limit are rejected
+    std::vector<int> clients;
+    for (auto i = 0U; i < diagram_server::kMaxConnections; i++) {
+        clients.push_back(connect_client());
+        REQUIRE(request(clients.back(), R"({"command": "list"})"
+                                        "\n")["status"] == "ok");
+    }
+
+    fd = connect_client();
+    response = request(fd, R"({"command": "list"})"
+                           "\n");
+    CHECK(response["status"] == "error");
+    close(fd);
+
+    for (const auto client : clients)
+        close(client);
+
+    // Closed connections are released, allowing new clients to connect
+    for (auto attempt = 0; attempt < 50; attempt++) {
+        fd = connect_client();
+        response = request(fd, R"({"command": "shutdown"})"
+                               "\n");
+        close(fd);
+        if (response["status"] == "ok")
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+    CHECK(response["status"] == "ok");
+
+    server_thread.join();
+}
+#endif
@@ -0,0 +1,12 @@
+namespace clanguml {
+namespace t90004 {
+
+class A { };
+
+class B {
+public:
+    A a;
+};
+
+} // namespace t90004
+} // namespace clanguml
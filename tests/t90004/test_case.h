@@ -0,0 +1,99 @@
+/**
+ * tests/t90004/test_case.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_WIN32)
+TEST_CASE("t90004")
+{
+    using namespace clanguml::test;
+    using clanguml::common::generator_type_t;
+    namespace fs = std::filesystem;
+
+    auto [config, db] = load_config("t90004");
+
+    const temporary_directory temp{"clanguml_t90004"};
+    const auto &output_directory = temp.path;
+
+    const auto diagram_file = output_directory / "t90004_class.puml";
+    const auto image = output_directory / "t90004_class.svg";
+
+    auto diagram = config.diagrams["t90004_class"];
+    diagram->puml().cmd =
+        fmt::format("touch {}/{{}}.svg", output_directory.string());
+
+    const std::map<std::string, std::vector<std::string>>
+        translation_units_map{
+            {"t90004_class", diagram->get_translation_units()}};
+
+    clanguml::cli::runtime_config runtime_config;
+    runtime_config.generators.push_back(generator_type_t::plantuml);
+    runtime_config.thread_count = 1;
+    runtime_config.render_diagrams = true;
+    runtime_config.render_batch_size = 1;
+    runtime_config.render_jobs = 1;
+    runtime_config.output_directory = output_directory.string();
+
+    auto generate = [&, &config = config, &db = db]() {
+        return clanguml::common::generators::generate_diagrams(
+            {"t90004_class"}, config, db, runtime_config,
+            translation_units_map);
+    };
+
+    REQUIRE(generate() == 0);
+    REQUIRE(fs::exists(diagram_file));
+    REQUIRE(fs::exists(image));
+
+    const auto diagram_time = fs::last_write_time(diagram_file);
+
+    // The diagram file is not written again, but the missing image is
+    // rendered
+    fs::remove(image);
+    REQUIRE(generate() == 0);
+    CHECK(fs::last_write_time(diagram_file) == diagram_time);
+    CHECK(fs::exists(image));
+
+    // Images older than the diagram file are rendered again
+    fs::last_write_time(image, diagram_time - std::chrono::hours{1});
+    REQUIRE(generate() == 0);
+    CHECK(fs::last_write_time(image) >= diagram_time);
+
+    // Up to date images are not rendered again
+    const auto image_time = diagram_time + std::chrono::hours{1};
+    fs::last_write_time(image, image_time);
+    REQUIRE(generate() == 0);
+    CHECK(fs::last_write_time(image) == image_time);
+
+    // Diagrams with unchanged inputs are skipped, also when the paths in
+    // the render command are quoted
+    diagram->puml().cmd = fmt::format(R"(cp "{0}/{{}}.puml" "{0}/{{}}.svg")",
+        output_directory.string());
+    runtime_config.incremental = true;
+    fs::remove(image);
+    REQUIRE(generate() == 0);
+    REQUIRE(fs::exists(image));
+
+    // Skipped diagrams are neither generated nor rendered again
+    std::stringstream modified;
+    modified << std::ifstream{diagram_file}.rdbuf() << "' modified\n";
+    std::ofstream{diagram_file} << modified.str();
+    fs::last_write_time(diagram_file, diagram_time);
+    fs::last_write_time(image, image_time);
+    REQUIRE(generate() == 0);
+    CHECK(clanguml::util::file_content_equals(diagram_file, modified.str()));
+    CHECK(fs::last_write_time(image) == image_time);
+}
+#endif
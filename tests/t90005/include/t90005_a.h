@@ -0,0 +1,13 @@
+#pragma once
+
+#include "t90005_common.h"
+
+namespace clanguml::t90005::a {
+
+struct A {
+    int get() const;
+
+    core::common c;
+};
+
+} // namespace clanguml::t90005::a
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "t90005_a.h"
+#include "t90005_common.h"
+
+namespace clanguml::t90005::b {
+
+struct B : public a::A {
+    int get() const;
+
+    core::common d;
+};
+
+int run();
+
+} // namespace clanguml::t90005::b
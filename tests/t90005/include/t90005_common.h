@@ -0,0 +1,9 @@
+#pragma once
+
+namespace clanguml::t90005::core {
+
+struct common {
+    int value() const { return 1; }
+};
+
+} // namespace clanguml::t90005::core
@@ -0,0 +1,11 @@
+#include "../include/t90005_a.h"
+
+namespace clanguml {
+namespace t90005 {
+namespace a {
+
+int A::get() const { return c.value(); }
+
+} // namespace a
+} // namespace t90005
+} // namespace clanguml
@@ -0,0 +1,17 @@
+#include "../include/t90005_b.h"
+
+namespace clanguml {
+namespace t90005 {
+namespace b {
+
+int B::get() const { return A::get() + d.value(); }
+
+int run()
+{
+    B b;
+    return b.get();
+}
+
+} // namespace b
+} // namespace t90005
+} // namespace clanguml
@@ -0,0 +1,112 @@
+/**
+ * tests/t90005/test_case.h
+ *
+ * Copyright (c) 2021-2024 Bartek Kryza <bkryza@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+TEST_CASE("t90005")
+{
+    using namespace clanguml::test;
+    using namespace clanguml::common::generators;
+    using clanguml::common::generator_type_t;
+    namespace fs = std::filesystem;
+
+    auto [config, db] = load_config("t90005");
+
+    const temporary_directory temp{"clanguml_t90005"};
+    const auto &output_directory = temp.path;
+
+    // Elements and files can be added to the merged models in a different
+    // order, while the order of messages in sequence diagrams must be kept
+    auto sorted_lines = [](const std::string &output) {
+        auto lines = clanguml::util::split(output, "\n");
+        std::sort(lines.begin(), lines.end());
+        return lines;
+    };
+
+    constexpr auto kShardCount{2U};
+
+    const fs::path compilation_database_dir{config.compilation_database_dir()};
+
+    // Translation units are assigned to the same shards in checkouts located
+    // in different directories
+    for (auto index = 1U; index <= kShardCount; index++) {
+        const auto a = shard_translation_units(
+            {"/a/src/x.cc", "/a/src/y.cc"}, "/a", index, kShardCount);
+        const auto b = shard_translation_units(
+            {"/b/c/src/x.cc", "/b/c/src/y.cc"}, "/b/c", index, kShardCount);
+        REQUIRE(a.size() == b.size());
+        for (auto i = 0U; i < a.size(); i++)
+            CHECK(fs::path{a[i]}.filename() == fs::path{b[i]}.filename());
+    }
+
+    for (const auto *name : {"t90005_include", "t90005_class",
+             "t90005_sequence", "t90005_package"}) {
+        INFO(name);
+
+        auto diagram = config.diagrams[name];
+        const auto translation_units = diagram->get_translation_units();
+        REQUIRE(translation_units.size() == 2);
+
+        // Each shard exports partial model of its subset of translation units
+        for (auto index = 1U; index <= kShardCount; index++) {
+            const auto shard_units = shard_translation_units(translation_units,
+                compilation_database_dir, index, kShardCount);
+
+            std::unique_ptr<clanguml::common::model::diagram> partial_model;
+            if (!shard_units.empty())
+                partial_model = generate_diagram_model(
+                    diagram, *db, shard_units, nullptr, {}, true);
+
+            export_partial_model(shard_path(output_directory.string(),
+                                     diagram->name, index, kShardCount),
+                *diagram, partial_model.get(), translation_units,
+                compilation_database_dir, index, kShardCount);
+        }
+
+        const auto merged_model =
+            merge_partial_models(*diagram, output_directory.string());
+        const auto model =
+            generate_diagram_model(diagram, *db, translation_units);
+
+        const auto merged_output = generate_diagram_output(
+            generator_type_t::plantuml, *diagram, *merged_model);
+        const auto output = generate_diagram_output(
+            generator_type_t::plantuml, *diagram, *model);
+
+        if (diagram->type() == clanguml::common::model::diagram_t::kSequence)
+            CHECK(merged_output == output);
+        else
+            CHECK(sorted_lines(merged_output) == sorted_lines(output));
+    }
+
+    auto diagram = config.diagrams["t90005_include"];
+    const auto translation_units = diagram->get_translation_units();
+
+    // Each translation unit must be processed by exactly one shard
+    for (auto index = 1U; index <= kShardCount; index++)
+        export_partial_model(shard_path(output_directory.string(),
+                                 diagram->name, index, kShardCount),
+            *diagram, nullptr, translation_units, compilation_database_dir, 1,
+            kShardCount);
+    CHECK_THROWS_AS(merge_partial_models(*diagram, output_directory.string()),
+        std::runtime_error);
+
+    // All shards are required to merge the diagram
+    fs::remove(shard_path(
+        output_directory.string(), diagram->name, kShardCount, kShardCount));
+    CHECK_THROWS_AS(merge_partial_models(*diagram, output_directory.string()),
+        std::runtime_error);
+}
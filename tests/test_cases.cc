@@ -20,13 +20,22 @@
 
 #include "cli/cli_handler.h"
 #include "common/compilation_database.h"
+#include "common/generators/diagram_server.h"
 #include "common/generators/generators.h"
+#include "common/generators/shard.h"
 #include "util/util.h"
 
 #include <spdlog/spdlog.h>
 
+#include <thread>
 #include <vector>
 
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 void inject_diagram_options(std::shared_ptr<clanguml::config::diagram> diagram)
 {
     // Inject links config to all test cases
@@ -644,6 +653,10 @@ void CHECK_INCLUDE_DIAGRAM(const clanguml::config::config &config,
 ///
 #include "t90000/test_case.h"
 #include "t90001/test_case.h"
+#include "t90002/test_case.h"
+#include "t90003/test_case.h"
+#include "t90004/test_case.h"
+#include "t90005/test_case.h"
 
 ///
 /// Main test function
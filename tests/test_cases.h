@@ -53,6 +53,54 @@ load_config(const std::string &test_name);
 
 namespace clanguml::test {
 
+/**
+ * Restores modification time of a file, when the test case changes it to
+ * simulate modification of a source file, even if the test case fails.
+ */
+struct last_write_time_guard {
+    explicit last_write_time_guard(std::filesystem::path p)
+        : path{std::move(p)}
+        , last_write_time{std::filesystem::last_write_time(path)}
+    {
+    }
+
+    last_write_time_guard(const last_write_time_guard &) = delete;
+    last_write_time_guard &operator=(const last_write_time_guard &) = delete;
+
+    ~last_write_time_guard()
+    {
+        std::error_code ec;
+        std::filesystem::last_write_time(path, last_write_time, ec);
+    }
+
+    std::filesystem::path path;
+    std::filesystem::file_time_type last_write_time;
+};
+
+/**
+ * Empty directory in the system temporary directory, which is removed with
+ * its contents at the end of the test case, even if the test case fails.
+ */
+struct temporary_directory {
+    explicit temporary_directory(const std::string &name)
+        : path{std::filesystem::temp_directory_path() / name}
+    {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+
+    temporary_directory(const temporary_directory &) = delete;
+    temporary_directory &operator=(const temporary_directory &) = delete;
+
+    ~temporary_directory()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    std::filesystem::path path;
+};
+
 template <typename T, typename... Ts> constexpr bool has_type() noexcept
 {
     return (std::is_same_v<T, Ts> || ... || false);
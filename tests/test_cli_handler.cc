@@ -209,4 +209,131 @@ TEST_CASE("Test cli handler puml config inheritance with render cmd")
         "mmdc -i output/{}.mmd -o output/{}.svg");
     REQUIRE(cli.config.diagrams.at("class_main")->puml().after.at(0) ==
         "' test comment");
-}
\ No newline at end of file
+}
+
+#if !defined(_WIN32)
+TEST_CASE("Test cli handler watch and daemon options")
+{
+    using clanguml::cli::cli_flow_t;
+    using clanguml::cli::cli_handler;
+
+    std::vector<const char *> argv{"clang-uml", "--config",
+        "./test_config_data/simple.yml", "--watch", "--daemon",
+        "clang-uml.sock"};
+
+    std::ostringstream ostr;
+    cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+    REQUIRE(cli.handle_options(argv.size(), argv.data()) == cli_flow_t::kError);
+}
+#endif
+
+TEST_CASE("Test cli handler incremental option")
+{
+    using clanguml::cli::cli_flow_t;
+    using clanguml::cli::cli_handler;
+
+    {
+        std::vector<const char *> argv{"clang-uml", "--config",
+            "./test_config_data/simple.yml", "--incremental"};
+
+        std::ostringstream ostr;
+        cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+        REQUIRE(cli.handle_options(argv.size(), argv.data()) ==
+            cli_flow_t::kContinue);
+        REQUIRE(cli.get_runtime_config().incremental);
+    }
+
+    {
+        std::vector<const char *> argv{"clang-uml", "--config",
+            "./test_config_data/simple.yml", "--incremental", "--watch"};
+
+        std::ostringstream ostr;
+        cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+        REQUIRE(cli.handle_options(argv.size(), argv.data()) ==
+            cli_flow_t::kError);
+    }
+}
+
+TEST_CASE("Test cli handler shard option and merge command")
+{
+    using clanguml::cli::cli_flow_t;
+    using clanguml::cli::cli_handler;
+
+    {
+        std::vector<const char *> argv{"clang-uml", "--config",
+            "./test_config_data/shard.yml", "--shard", "2/3", "-n",
+            "include_main"};
+
+        std::ostringstream ostr;
+        cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+        auto res = cli.handle_options(argv.size(), argv.data());
+
+        REQUIRE(res == cli_flow_t::kContinue);
+        REQUIRE(cli.get_runtime_config().shard_index == 2);
+        REQUIRE(cli.get_runtime_config().shard_count == 3);
+        REQUIRE(!cli.merge);
+    }
+
+    for (const auto *shard : {"0/3", "4/3", "1/0", "2", "a/b", "4294967297/2",
+             "1/4294967298", "-1/2", "+1/2", " 1/2", "1x/2", "1/"}) {
+        std::vector<const char *> argv{"clang-uml", "--config",
+            "./test_config_data/shard.yml", "--shard", shard, "-n",
+            "include_main"};
+
+        std::ostringstream ostr;
+        cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+        REQUIRE(cli.handle_options(argv.size(), argv.data()) ==
+            cli_flow_t::kError);
+    }
+
+    {
+        std::vector<const char *> argv{"clang-uml", "--config",
+            "./test_config_data/shard.yml", "merge", "-n", "include_main"};
+
+        std::ostringstream ostr;
+        cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+        auto res = cli.handle_options(argv.size(), argv.data());
+
+        REQUIRE(res == cli_flow_t::kContinue);
+        REQUIRE(cli.merge);
+        REQUIRE(cli.get_runtime_config().shard_count == 0);
+        REQUIRE(cli.diagram_names == std::vector<std::string>{"include_main"});
+    }
+
+    // Diagrams of all types can be generated in shards
+    for (const auto &options : std::vector<std::vector<const char *>>{
+             {"--shard", "1/2"}, {"--shard", "1/2", "-n", "class_main"},
+             {"merge"}, {"merge", "-n", "class_main"}}) {
+        std::vector<const char *> argv{
+            "clang-uml", "--config", "./test_config_data/shard.yml"};
+        argv.insert(argv.end(), options.begin(), options.end());
+
+        std::ostringstream ostr;
+        cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+        REQUIRE(cli.handle_options(argv.size(), argv.data()) ==
+            cli_flow_t::kContinue);
+    }
+
+    // Shards cannot be combined with options which keep state between runs
+    for (const auto &options : std::vector<std::vector<const char *>>{
+             {"--shard", "1/2", "-n", "include_main", "--watch"},
+             {"--shard", "1/2", "-n", "include_main", "--incremental"},
+             {"merge", "--shard", "1/2"}}) {
+        std::vector<const char *> argv{
+            "clang-uml", "--config", "./test_config_data/shard.yml"};
+        argv.insert(argv.end(), options.begin(), options.end());
+
+        std::ostringstream ostr;
+        cli_handler cli{ostr, make_sstream_logger(ostr)};
+
+        REQUIRE(cli.handle_options(argv.size(), argv.data()) ==
+            cli_flow_t::kError);
+    }
+}
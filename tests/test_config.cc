@@ -442,6 +442,23 @@ TEST_CASE("Test config type aliases")
         "std::vector<std::string>");
 }
 
+TEST_CASE("Test config comments_required")
+{
+    auto cfg =
+        clanguml::config::load("./test_config_data/comments_required.yml");
+
+    CHECK(cfg.diagrams.size() == 8);
+
+    CHECK_FALSE(cfg.diagrams["no_comments"]->comments_required());
+    CHECK(cfg.diagrams["message_comments"]->comments_required());
+    CHECK(cfg.diagrams["plantuml_before"]->comments_required());
+    CHECK(cfg.diagrams["plantuml_after"]->comments_required());
+    CHECK(cfg.diagrams["mermaid_before"]->comments_required());
+    CHECK(cfg.diagrams["mermaid_after"]->comments_required());
+    CHECK(cfg.diagrams["link"]->comments_required());
+    CHECK(cfg.diagrams["tooltip"]->comments_required());
+}
+
 ///
 /// Main test function
 ///
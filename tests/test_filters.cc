@@ -149,6 +149,13 @@ TEST_CASE("Test namespaces filter")
     CHECK(!filter.should_include(namespace_{"ns1::ns2::detail::more_detail"}));
     CHECK(!filter.should_include(namespace_{"ns1::interface"}));
 
+    CHECK(!filter.excludes_namespace_subtree(namespace_{"ns1"}));
+    CHECK(!filter.excludes_namespace_subtree(namespace_{"ns1::ns2"}));
+    CHECK(!filter.excludes_namespace_subtree(namespace_{"ns1::ns2::ns3"}));
+    CHECK(filter.excludes_namespace_subtree(namespace_{"ns1::ns2::detail"}));
+    CHECK(filter.excludes_namespace_subtree(namespace_{"ns1::interface"}));
+    CHECK(filter.excludes_namespace_subtree(namespace_{"std"}));
+
     package p{{}};
 
     p.set_namespace({"ns1"});
@@ -252,6 +259,10 @@ TEST_CASE("Test namespaces regexp filter")
     CHECK(!filter.should_include(namespace_{"ns1::ns2::detail"}));
     CHECK(filter.should_include(namespace_{"ns1::interface"}));
 
+    // Regular expressions can match any nested namespace
+    CHECK(!filter.excludes_namespace_subtree(namespace_{"ns1::ns2::detail"}));
+    CHECK(!filter.excludes_namespace_subtree(namespace_{"std"}));
+
     package p{{}};
 
     p.set_namespace({"ns1"});
@@ -23,6 +23,7 @@
 #include "common/model/namespace.h"
 #include "common/model/package.h"
 #include "common/model/template_parameter.h"
+#include "sequence_diagram/model/diagram.h"
 
 TEST_CASE("Test namespace_")
 {
@@ -468,4 +469,52 @@ TEST_CASE("Test common::model::package full_name")
         CHECK(pkg.full_name(false) == "A.B.C:D");
         CHECK(pkg.full_name(true) == ":D");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test sequence_diagram::model::diagram message chains")
+{
+    using clanguml::common::eid_t;
+    using clanguml::common::model::message_t;
+    using clanguml::sequence_diagram::model::diagram;
+    using clanguml::sequence_diagram::model::message;
+
+    auto call = [](uint64_t from, uint64_t to) {
+        message m{message_t::kCall, eid_t{from}};
+        m.set_to(eid_t{to});
+        m.set_message_name(fmt::format("{}->{}", from, to));
+        return m;
+    };
+
+    // 1 -> 2 -> 4
+    // 1 -> 3 -> 4
+    // 1 -> 4 (twice)
+    // 3 -> 5 -> 3 (loop)
+    diagram d;
+    d.add_message(call(1, 2));
+    d.add_message(call(1, 3));
+    d.add_message(call(1, 4));
+    d.add_message(call(1, 4));
+    d.add_message(call(2, 4));
+    d.add_message(call(3, 4));
+    d.add_message(call(3, 5));
+    d.add_message(call(5, 3));
+
+    auto chains = d.get_all_from_to_message_chains(eid_t{}, eid_t{4ULL});
+    REQUIRE(chains.size() == 4);
+    for (const auto &mc : chains) {
+        CHECK(mc.back().to() == eid_t{4ULL});
+    }
+
+    chains = d.get_all_from_to_message_chains(eid_t{1ULL}, eid_t{3ULL});
+    REQUIRE(chains.size() == 1);
+    CHECK(chains[0].size() == 1);
+
+    chains = d.get_all_from_to_message_chains(eid_t{}, eid_t{4ULL}, 2);
+    CHECK(chains.size() == 2);
+
+    chains = d.get_all_from_to_message_chains(eid_t{}, eid_t{4ULL}, 0, 1);
+    REQUIRE(chains.size() == 3);
+    for (const auto &mc : chains) {
+        CHECK(mc.size() == 1);
+    }
+}
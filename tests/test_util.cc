@@ -17,10 +17,29 @@
  */
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include "common/generators/manifest.h"
+#include "common/generators/memory_budget.h"
+#include "common/generators/render_queue.h"
+#include "util/file_watcher.h"
+#include "util/flat_hash_map.h"
+#include "util/interned_string.h"
 #include "util/util.h"
 #include <common/clang_utils.h>
 
+#include <clang/AST/DeclCXX.h>
+#include <clang/Frontend/ASTUnit.h>
+#include <clang/Tooling/Tooling.h>
+
+#include <nlohmann/json.hpp>
+#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
 
 #include "doctest/doctest.h"
 
@@ -45,6 +64,21 @@ TEST_CASE("Test split")
     CHECK(split("std::vector::detail::", "::") == C{"std", "vector", "detail"});
 }
 
+TEST_CASE("Test split_command_line")
+{
+    using C = std::vector<std::string>;
+    using namespace clanguml::util;
+
+    CHECK(split_command_line("") == C{});
+    CHECK(split_command_line("  a   b\tc ") == C{"a", "b", "c"});
+    CHECK(split_command_line("plantuml -tsvg \"docs/diagrams/{}.puml\"") ==
+        C{"plantuml", "-tsvg", "docs/diagrams/{}.puml"});
+    CHECK(split_command_line("a 'b c' \"d e\"f") == C{"a", "b c", "d ef"});
+    CHECK(split_command_line("a '' \"\"") == C{"a", "", ""});
+    CHECK(split_command_line("a\\ b \"c\\\"d\\x\" 'e\\f'") ==
+        C{"a b", "c\"d\\x", "e\\f"});
+}
+
 TEST_CASE("Test abbreviate")
 {
     using namespace clanguml::util;
@@ -95,6 +129,229 @@ TEST_CASE("Test replace_all")
     CHECK(text == orig);
 }
 
+TEST_CASE("Test expand_command_template")
+{
+    using namespace clanguml::util;
+
+    CHECK(expand_command_template("plantuml -tsvg diagrams/{}.puml", {"A"}) ==
+        "plantuml -tsvg diagrams/A.puml");
+    CHECK(expand_command_template(
+              "plantuml -tsvg diagrams/{}.puml", {"A", "B", "C"}) ==
+        "plantuml -tsvg diagrams/A.puml diagrams/B.puml diagrams/C.puml");
+    CHECK(expand_command_template("{}.sh --verbose", {"A", "B"}) ==
+        "A.sh B.sh --verbose");
+    CHECK(expand_command_template("mmdc -i {}.mmd -o {}.svg", {"A"}) ==
+        "mmdc -i A.mmd -o A.svg");
+    CHECK_FALSE(
+        expand_command_template("mmdc -i {}.mmd -o {}.svg", {"A", "B"}));
+    CHECK_FALSE(expand_command_template("plantuml -tsvg *.puml", {"A", "B"}));
+
+    // Quoted placeholder arguments are only expanded for a single value
+    CHECK(expand_command_template(
+              "plantuml -tsvg \"out dir/{}.puml\"", {"A"}) ==
+        "plantuml -tsvg \"out dir/A.puml\"");
+    CHECK_FALSE(expand_command_template(
+        "plantuml -tsvg \"out dir/{}.puml\"", {"A", "B"}));
+    CHECK_FALSE(expand_command_template(
+        "plantuml -tsvg 'out {} dir/x.puml'", {"A", "B"}));
+    CHECK_FALSE(expand_command_template(
+        "plantuml -tsvg out\\ dir/{}.puml", {"A", "B"}));
+    CHECK(expand_command_template(
+              "plantuml -o \"out dir\" -tsvg {}.puml", {"A", "B"}) ==
+        "plantuml -o \"out dir\" -tsvg A.puml B.puml");
+}
+
+#if !defined(_WIN32)
+TEST_CASE("Test render_queue failures")
+{
+    using clanguml::common::generator_type_t;
+    using clanguml::common::generators::render_queue;
+
+    // Render commands and their failures are logged, the logger stays
+    // registered after the test
+    static std::ostringstream log;
+    clanguml::util::register_logger(std::make_shared<spdlog::logger>(
+        "clanguml-logger",
+        std::make_shared<spdlog::sinks::ostream_sink_mt>(log)));
+
+    clanguml::config::class_diagram ok;
+    ok.name = "ok";
+    ok.puml.set({});
+    ok.puml().cmd = "true {}";
+    ok.mermaid.set({});
+    ok.mermaid().cmd = "true {}";
+
+    clanguml::config::class_diagram failing;
+    failing.name = "failing";
+    failing.puml.set({});
+    failing.puml().cmd = "false {}";
+
+    render_queue renders{2, 2};
+    renders.add(generator_type_t::plantuml, ok);
+    renders.add(generator_type_t::mermaid, ok);
+    renders.add(generator_type_t::plantuml, failing);
+    // JSON diagrams are not rendered
+    renders.add(generator_type_t::json, failing);
+
+    CHECK(renders.wait() == 1);
+    CHECK(log.str().find("Failed to render diagrams failing") !=
+        std::string::npos);
+}
+#endif
+
+TEST_CASE("Test render_queue rendered_path")
+{
+    using clanguml::common::generator_type_t;
+    using clanguml::common::generators::render_queue;
+    using std::filesystem::path;
+
+    clanguml::config::class_diagram diagram;
+    diagram.name = "A";
+    diagram.puml.set({});
+    diagram.mermaid.set({});
+
+    diagram.puml().cmd = "plantuml -tsvg output/{}.puml";
+    CHECK(render_queue::rendered_path(generator_type_t::plantuml, diagram) ==
+        path{"output/A.svg"});
+
+    diagram.puml().cmd = "plantuml output/{}.puml";
+    CHECK(render_queue::rendered_path(generator_type_t::plantuml, diagram) ==
+        path{"output/A.png"});
+
+    diagram.puml().cmd = "plantuml -tsvg \"output dir/{}.puml\"";
+    CHECK(render_queue::rendered_path(generator_type_t::plantuml, diagram) ==
+        path{"output dir/A.svg"});
+
+    diagram.puml().cmd = "plantuml '-tsvg' 'output/{}.puml'";
+    CHECK(render_queue::rendered_path(generator_type_t::plantuml, diagram) ==
+        path{"output/A.svg"});
+
+    diagram.puml().cmd = "plantuml -tsvg -o images output/{}.puml";
+    CHECK_FALSE(
+        render_queue::rendered_path(generator_type_t::plantuml, diagram));
+
+    diagram.mermaid().cmd = "mmdc -i output/{}.mmd -o images/{}.svg";
+    CHECK(render_queue::rendered_path(generator_type_t::mermaid, diagram) ==
+        path{"images/A.svg"});
+
+    diagram.mermaid().cmd = "mmdc -i \"output/{}.mmd\" -o \"images/{}.svg\"";
+    CHECK(render_queue::rendered_path(generator_type_t::mermaid, diagram) ==
+        path{"images/A.svg"});
+
+    diagram.mermaid().cmd = "mmdc -i output/{}.mmd";
+    CHECK_FALSE(
+        render_queue::rendered_path(generator_type_t::mermaid, diagram));
+
+    CHECK_FALSE(render_queue::rendered_path(generator_type_t::json, diagram));
+}
+
+TEST_CASE("Test manifest")
+{
+    using clanguml::common::generators::manifest;
+    namespace fs = std::filesystem;
+
+    const auto dir = fs::temp_directory_path() / "clanguml_test_manifest";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    const auto path = dir / manifest::kFileName;
+    const auto a = (dir / "a.h").string();
+    const auto b = (dir / "b.h").string();
+    std::ofstream{a} << "a";
+    std::ofstream{b} << "b";
+
+    // Files are recorded only if they were not modified after the diagram
+    // generation started
+    const auto past = fs::file_time_type::clock::now() - std::chrono::hours{1};
+    fs::last_write_time(a, past);
+    fs::last_write_time(b, past);
+    const auto started = fs::file_time_type::clock::now();
+
+    manifest inputs{path};
+    CHECK_FALSE(inputs.is_up_to_date("d", "fingerprint"));
+
+    inputs.update("d", "fingerprint", {a, b}, started);
+    CHECK(inputs.is_up_to_date("d", "fingerprint"));
+    CHECK_FALSE(inputs.is_up_to_date("d", "other fingerprint"));
+    CHECK_FALSE(inputs.is_up_to_date("other", "fingerprint"));
+    CHECK(inputs.files("d") == std::set<std::string>{a, b});
+
+    inputs.write();
+
+    manifest previous{path};
+    CHECK(previous.is_up_to_date("d", "fingerprint"));
+
+    // Modifying any of the dependencies invalidates the diagram
+    std::ofstream{b} << "bb";
+    CHECK_FALSE(previous.is_up_to_date("d", "fingerprint"));
+
+    // Diagrams whose dependencies were modified during generation are
+    // generated again
+    previous.update("d", "fingerprint", {a, b}, started);
+    CHECK_FALSE(previous.is_up_to_date("d", "fingerprint"));
+
+    const auto b_write_time = past + std::chrono::minutes{1};
+    fs::last_write_time(b, b_write_time);
+    previous.update("d", "fingerprint", {a, b}, started);
+    CHECK(previous.is_up_to_date("d", "fingerprint"));
+    previous.write();
+
+    // Files with unchanged size and modification time are not hashed
+    std::ofstream{b} << "xx";
+    fs::last_write_time(b, b_write_time);
+    CHECK(manifest{path}.is_up_to_date("d", "fingerprint"));
+
+    // Touched files are hashed, and their new time recorded
+    std::ofstream{b} << "bb";
+    fs::last_write_time(b, b_write_time + std::chrono::hours{1});
+    manifest touched{path};
+    CHECK(touched.is_up_to_date("d", "fingerprint"));
+    touched.write();
+    const auto recorded = nlohmann::json::parse(std::ifstream{path});
+    CHECK(recorded["diagrams"]["d"]["files"][b]["mtime"] ==
+        fs::last_write_time(b).time_since_epoch().count());
+
+    previous.remove("d");
+    CHECK_FALSE(previous.is_up_to_date("d", "fingerprint"));
+    CHECK(previous.files("d").empty());
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Test memory_budget")
+{
+    using clanguml::common::generators::memory_budget;
+    using clanguml::common::generators::memory_budget_guard;
+
+    // The limit is always exceeded, so only one task can run at a time
+    memory_budget budget{1};
+    CHECK(budget.limit_kb() == 1024);
+
+#if defined(__linux) || defined(__APPLE__)
+    CHECK(memory_budget::current_rss_kb() > budget.limit_kb());
+
+    std::atomic<bool> second_running{false};
+    std::thread second;
+    {
+        memory_budget_guard guard{&budget};
+
+        // A single task is never blocked by the budget
+        budget.checkpoint();
+
+        second = std::thread{[&budget, &second_running] {
+            memory_budget_guard second_guard{&budget};
+            second_running = true;
+        }};
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{300});
+        CHECK_FALSE(second_running);
+    }
+
+    second.join();
+    CHECK(second_running);
+#endif
+}
+
 TEST_CASE("Test extract_template_parameter_index")
 {
     using namespace clanguml::common;
@@ -287,6 +544,41 @@ TEST_CASE("Test hash_seed")
     CHECK(hash_seed(1) != hash_seed(2));
 }
 
+TEST_CASE("Test stable_hash")
+{
+    using namespace clanguml::util;
+
+    // XXH64 reference values
+    CHECK(stable_hash("") == 0xEF46DB3751D8E999ULL);
+    CHECK(stable_hash("a") == 0xD24EC4F1A98C6E5BULL);
+    CHECK(stable_hash("abc") == 0x44BC2CF5AD770999ULL);
+    CHECK(stable_hash("Nobody inspects the spammish repetition") ==
+        0xFBCEA83C8A378BF1ULL);
+
+    CHECK(stable_hash("abc", 1) != stable_hash("abc"));
+}
+
+TEST_CASE("Test file_content_equals")
+{
+    using namespace clanguml::util;
+    namespace fs = std::filesystem;
+
+    const auto path =
+        fs::temp_directory_path() / "clanguml_test_file_content_equals.txt";
+    const auto content = std::string(40000, 'x') + "\nabc\n";
+
+    // Files are compared in text mode, like diagrams are written
+    std::ofstream{path} << content;
+
+    CHECK(file_content_equals(path, content));
+    CHECK_FALSE(file_content_equals(path, content + "x"));
+    CHECK_FALSE(file_content_equals(path, content.substr(1)));
+    CHECK_FALSE(file_content_equals(path, std::string(40005, 'y')));
+    CHECK_FALSE(file_content_equals(path.string() + ".missing", ""));
+
+    fs::remove(path);
+}
+
 TEST_CASE("Test tokenize_unexposed_template_parameter")
 {
     using namespace clanguml::common;
@@ -432,6 +724,45 @@ TEST_CASE("Test is_relative_to")
     CHECK_FALSE(is_relative_to(child, base2));
 }
 
+TEST_CASE("Test cached_weakly_canonical")
+{
+    namespace fs = std::filesystem;
+    using clanguml::util::cached_weakly_canonical;
+
+    const auto dir = fs::temp_directory_path() / "clanguml_test_canonical";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "a" / "b");
+
+    for (const auto &p : {dir / "a" / ".." / "a" / "b" / "file.h",
+             dir / "a" / "b" / ".." / "missing" / "file.h", dir / "a" / "b"}) {
+        const auto expected = fs::weakly_canonical(p);
+
+        // The second call is served from the cache
+        CHECK(cached_weakly_canonical(p) == expected);
+        CHECK(cached_weakly_canonical(p) == expected);
+    }
+
+    CHECK(cached_weakly_canonical(fs::path{"a/../b"}) ==
+        fs::weakly_canonical(fs::path{"a/../b"}));
+
+#if !defined(_WIN32)
+    // Cached paths are only refreshed after the cache is cleared
+    const auto link = dir / "link";
+    const auto a = fs::weakly_canonical(dir / "a");
+    fs::create_directory_symlink(dir / "a", link);
+    CHECK(cached_weakly_canonical(link / "file.h") == a / "file.h");
+
+    fs::remove(link);
+    fs::create_directory_symlink(dir / "a" / "b", link);
+    CHECK(cached_weakly_canonical(link / "file.h") == a / "file.h");
+
+    clanguml::util::clear_weakly_canonical_cache();
+    CHECK(cached_weakly_canonical(link / "file.h") == a / "b" / "file.h");
+#endif
+
+    fs::remove_all(dir);
+}
+
 TEST_CASE("Test parse_source_location")
 {
     using namespace clanguml::common;
@@ -474,4 +805,203 @@ TEST_CASE("Test parse_source_location")
     CHECK(column == 456);
 
     result = false, file = "", line = 0, column = 0;
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test type_name_cache")
+{
+    using clanguml::common::eid_t;
+    using clanguml::common::to_id;
+    using clanguml::common::type_name_cache;
+
+    const auto ast = clang::tooling::buildASTFromCodeWithArgs(R"(
+namespace ns {
+template <typename T> struct A { T t; };
+using B = A<int>;
+enum class E { e1, e2 };
+struct C {
+    A<int> a;
+    B b;
+    const B *c;
+    A<E> d[2];
+    int e;
+};
+})",
+        {"-std=c++17"});
+    REQUIRE(ast);
+
+    const auto &ctx = ast->getASTContext();
+
+    std::vector<const clang::NamespaceDecl *> namespaces;
+    std::vector<const clang::TagDecl *> tags;
+    std::vector<clang::QualType> types;
+
+    for (const auto *decl : ctx.getTranslationUnitDecl()->decls()) {
+        const auto *ns = llvm::dyn_cast<clang::NamespaceDecl>(decl);
+        if (ns == nullptr)
+            continue;
+
+        namespaces.push_back(ns);
+
+        for (const auto *ns_decl : ns->decls()) {
+            const auto *tag = llvm::dyn_cast<clang::TagDecl>(ns_decl);
+            if (tag == nullptr)
+                continue;
+
+            tags.push_back(tag);
+
+            if (const auto *record = llvm::dyn_cast<clang::RecordDecl>(tag);
+                record != nullptr) {
+                for (const auto *field : record->fields())
+                    types.push_back(field->getType());
+            }
+        }
+    }
+
+    REQUIRE(namespaces.size() == 1);
+    REQUIRE(tags.size() == 2);
+    REQUIRE(types.size() == 5);
+
+    const auto compute = [&]() {
+        std::vector<std::string> names;
+        std::vector<eid_t> ids;
+        for (const auto &type : types) {
+            names.push_back(clanguml::common::to_string(type, ctx));
+            names.push_back(clanguml::common::to_string(type, ctx, false));
+            ids.push_back(to_id(type, ctx));
+        }
+        for (const auto *tag : tags)
+            ids.push_back(to_id(*tag));
+        for (const auto *ns : namespaces)
+            ids.push_back(to_id(*ns));
+
+        return std::make_pair(names, ids);
+    };
+
+    CHECK(type_name_cache::current() == nullptr);
+
+    const auto uncached = compute();
+
+    {
+        type_name_cache cache;
+        CHECK(type_name_cache::current() == &cache);
+
+        // The first pass fills the cache, the second one only reads it
+        CHECK(compute() == uncached);
+        CHECK(compute() == uncached);
+    }
+
+    CHECK(type_name_cache::current() == nullptr);
+}
+
+TEST_CASE("Test interned_string")
+{
+    using clanguml::util::interned_string;
+
+    const auto initial_size = interned_string::pool_size();
+
+    {
+        interned_string a{"interned_string test value"};
+        interned_string b{std::string{"interned_string test value"}};
+        interned_string c{"interned_string other value"};
+
+        CHECK(a == b);
+        CHECK(a != c);
+        CHECK(&a.str() == &b.str());
+        CHECK(a.str() == "interned_string test value");
+        CHECK(interned_string::pool_size() == initial_size + 2);
+
+        interned_string d{a};
+        interned_string e{std::move(b)};
+        CHECK(d == a);
+        CHECK(e == a);
+        CHECK(b.empty());
+
+        c = d;
+        CHECK(c == a);
+        CHECK(interned_string::pool_size() == initial_size + 1);
+
+        interned_string empty;
+        CHECK(empty.empty());
+        CHECK(empty == interned_string{""});
+    }
+
+    // Strings are released with their last reference
+    CHECK(interned_string::pool_size() == initial_size);
+}
+
+TEST_CASE("Test flat_hash_map")
+{
+    using namespace clanguml::util;
+
+    flat_hash_map<int64_t, std::string> m;
+
+    CHECK(m.empty());
+    CHECK(m.find(1) == m.end());
+
+    for (int64_t i = 0; i < 1000; i++)
+        CHECK(m.emplace(i * 16, std::to_string(i)).second);
+
+    CHECK(m.size() == 1000);
+    CHECK_FALSE(m.emplace(16, "x").second);
+    CHECK(m.at(16) == "1");
+    CHECK(m.find(17) == m.end());
+    CHECK_THROWS_AS(m.at(17), std::out_of_range);
+
+    for (int64_t i = 0; i < 1000; i += 2)
+        CHECK(m.erase(i * 16) == 1);
+
+    CHECK(m.erase(0) == 0);
+    CHECK(m.size() == 500);
+
+    for (int64_t i = 0; i < 1000; i++)
+        CHECK(m.count(i * 16) == static_cast<size_t>(i % 2));
+
+    std::size_t count{0};
+    for (const auto &[k, v] : m) {
+        CHECK(std::to_string(k / 16) == v);
+        count++;
+    }
+    CHECK(count == 500);
+
+    m[3] = "three";
+    CHECK(m.at(3) == "three");
+
+    m.clear();
+    CHECK(m.empty());
+    CHECK(m.find(16) == m.end());
+}
+
+TEST_CASE("Test file_watcher")
+{
+    using namespace clanguml::util;
+    namespace fs = std::filesystem;
+
+    const auto dir = fs::temp_directory_path() / "clanguml_test_file_watcher";
+    fs::create_directories(dir);
+
+    const auto a = (dir / "a.h").string();
+    const auto b = (dir / "b.h").string();
+    std::ofstream{a} << "a";
+    std::ofstream{b} << "b";
+
+    file_watcher watcher;
+    watcher.watch({a, (dir / "." / "b.h").string()});
+
+    // Files not in the watched set are ignored
+    std::ofstream{(dir / "c.h").string()} << "c";
+    std::ofstream{b} << "bb";
+
+    constexpr auto kTimeout = std::chrono::seconds{10};
+    CHECK(watcher.wait(kTimeout) == std::set<std::string>{b});
+
+    // Without any changes, the wait ends after the timeout
+    CHECK(watcher.wait(std::chrono::milliseconds{100}).empty());
+
+#if defined(__linux)
+    // Waiting would block forever, if none of the files can be watched
+    CHECK_THROWS_AS(watcher.watch({(dir / "missing" / "d.h").string()}),
+        std::runtime_error);
+#endif
+
+    fs::remove_all(dir);
+}